@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <thread>
+
+#include <Concurrency/IAsyncScheduledWorker.hpp>
+#include <Concurrency/PooledScheduler.hpp>
+#include <Concurrency/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+#if !CONCURRENCY_HAS_COROUTINES
+#error "AsyncWorkerTest needs a compiler with C++20 coroutines"
+#endif
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    // Resumes the awaiting coroutine on a thread that is not a pool thread, like an I/O completion.
+    struct ResumeOnForeignThread
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            std::thread([handle]() { handle.resume(); }).detach();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    // Waits on the scheduler's timer, hops through a foreign thread and back onto the pool.
+    class DelayingWorker : public IAsyncScheduledWorker
+    {
+    public:
+        DelayingWorker(PooledScheduler& scheduler, Millisecond delay)
+            : scheduler(scheduler), delay(delay), started(0), completed(0), inFlight(0), overlaps(0), offPool(0)
+        {
+        }
+
+        Task<void> RunOnceAsync() override
+        {
+            started.fetch_add(1);
+            overlaps.fetch_add(inFlight.fetch_add(1) != 0);
+            const auto before = std::chrono::steady_clock::now();
+            co_await scheduler.Delay(delay);
+            offPool.fetch_add(ThreadPool::GetCurrent() == nullptr);
+            offPool.fetch_add(std::chrono::steady_clock::now() - before < std::chrono::milliseconds(delay));
+            co_await ResumeOnForeignThread();
+            co_await scheduler.Schedule();
+            offPool.fetch_add(ThreadPool::GetCurrent() == nullptr);
+            inFlight.fetch_sub(1);
+            completed.fetch_add(1);
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "delaying";
+        }
+
+        void NotifyDurationTimeout(const bool&) const override
+        {
+        }
+
+        PooledScheduler& scheduler;
+        const Millisecond delay;
+        std::atomic<int> started;
+        std::atomic<int> completed;
+        std::atomic<int> inFlight;
+        std::atomic<int> overlaps;
+        std::atomic<int> offPool;
+    };
+
+    // Executions resume on the pool after their delay, and the next one only starts once the
+    // previous has completed. Detach waits for a suspended execution.
+    void TestDelayScheduleAndDetach()
+    {
+        PooledScheduler scheduler(0, 2);
+        DelayingWorker worker(scheduler, 10);
+        scheduler.Attach(worker, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.completed.load() >= 3; }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.inFlight.load() == 1; }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(scheduler.Detach(worker));
+        CONCURRENCY_CHECK(worker.inFlight.load() == 0 && worker.started.load() == worker.completed.load());
+        const int completed = worker.completed.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        CONCURRENCY_CHECK(worker.started.load() == completed);
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(worker.overlaps.load() == 0);
+        CONCURRENCY_CHECK(worker.offPool.load() == 0);
+    }
+
+    // Deactivate waits for executions suspended on a delay.
+    void TestDeactivateWaitsForSuspended()
+    {
+        PooledScheduler scheduler(0, 2);
+        DelayingWorker worker(scheduler, 50);
+        scheduler.Attach(worker, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.started.load() >= 1; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(worker.inFlight.load() == 0 && worker.started.load() == worker.completed.load());
+    }
+
+    // Outside of PooledScheduler, RunOnce() blocks until the coroutine has completed.
+    void TestRunOnceBlocks()
+    {
+        PooledScheduler scheduler(0, 1);
+        scheduler.Activate();
+        DelayingWorker worker(scheduler, 5);
+        worker.RunOnce();
+        CONCURRENCY_CHECK(worker.completed.load() == 1);
+        scheduler.Deactivate();
+    }
+} // namespace
+
+int main()
+{
+    TestDelayScheduleAndDetach();
+    TestDeactivateWaitsForSuspended();
+    TestRunOnceBlocks();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,187 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/BasicScheduler.hpp>
+#include <Concurrency/StaticWorker.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    typedef BasicScheduler<std::chrono::steady_clock, SleepIdlePolicy, NullLogPolicy> SleepScheduler;
+
+    // A clock that only moves when the test or the idle policy moves it.
+    struct ManualClock
+    {
+        typedef std::chrono::microseconds duration;
+        typedef duration::rep rep;
+        typedef duration::period period;
+        typedef std::chrono::time_point<ManualClock> time_point;
+        static constexpr bool is_steady = true;
+
+        static time_point now()
+        {
+            return time_point(duration(Current()));
+        }
+
+        static void Advance(std::chrono::milliseconds by)
+        {
+            Current() += std::chrono::duration_cast<duration>(by).count();
+        }
+
+        static rep& Current()
+        {
+            static rep current = 0;
+            return current;
+        }
+    };
+
+    struct JumpIdlePolicy
+    {
+        void WaitUntil(const ManualClock::time_point& deadline)
+        {
+            if (ManualClock::now() < deadline)
+            {
+                ManualClock::Current() = deadline.time_since_epoch().count();
+            }
+        }
+    };
+
+    struct FaultCountingMonitor
+    {
+        FaultCountingMonitor(const Microsecond, const Microsecond) : starts(0), faults(0)
+        {
+        }
+
+        void Start()
+        {
+            ++starts;
+        }
+
+        void Stop()
+        {
+        }
+
+        void IncrementIntervalFaultCount()
+        {
+            ++faults;
+        }
+
+        int starts;
+        int faults;
+    };
+
+    class RecordingWorker
+    {
+    public:
+        RecordingWorker() : sleep(0), throws(false), runs(0), timeouts(0), inTime(0)
+        {
+        }
+
+        void RunOnce()
+        {
+            runs.fetch_add(1);
+            std::this_thread::sleep_for(sleep);
+            if (throws)
+            {
+                throw std::runtime_error("worker");
+            }
+        }
+
+        const char* GetWorkerName() const
+        {
+            return "recording";
+        }
+
+        void NotifyDurationTimeout(const bool& isTimeout)
+        {
+            (isTimeout ? timeouts : inTime).fetch_add(1);
+        }
+
+        std::chrono::milliseconds sleep;
+        bool throws;
+        std::atomic<int> runs;
+        std::atomic<int> timeouts;
+        std::atomic<int> inTime;
+    };
+
+    // Jobs of different intervals run on the scheduler thread until it stops.
+    void TestStartRunsEveryJob()
+    {
+        std::atomic<int> fast(0);
+        std::atomic<int> slow(0);
+        auto fastWorker = MakeStaticWorker("fast", [&fast]() { fast.fetch_add(1); });
+        auto slowWorker = MakeStaticWorker("slow", [&slow]() { slow.fetch_add(1); });
+        SleepScheduler scheduler;
+        auto fastJob = SleepScheduler::MakeJob(fastWorker, 1);
+        auto slowJob = SleepScheduler::MakeJob(slowWorker, 20);
+        CONCURRENCY_CHECK(scheduler.Start(0, fastJob, slowJob));
+        CONCURRENCY_CHECK(!scheduler.Start(0, fastJob, slowJob));
+        CONCURRENCY_CHECK(WaitFor([&slow]() { return slow.load() >= 3; }, std::chrono::seconds(5)));
+        scheduler.Stop();
+        CONCURRENCY_CHECK(fast.load() > slow.load());
+        CONCURRENCY_CHECK(std::string(fastJob.GetWorker().GetWorkerName()) == "fast");
+    }
+
+    // A late job runs once for the latest slot that has passed, and the missed slots are faults.
+    void TestMissedSlotsCollapse()
+    {
+        typedef BasicScheduler<ManualClock, JumpIdlePolicy, NullLogPolicy, FaultCountingMonitor> ManualScheduler;
+        ManualClock::Current() = 0;
+        ManualScheduler scheduler;
+        std::vector<long long> runAt;
+        auto worker = MakeStaticWorker("late", [&]() {
+            runAt.push_back(ManualClock::now().time_since_epoch().count() / 1000);
+            if (runAt.size() == 3)
+            {
+                ManualClock::Advance(std::chrono::milliseconds(55));
+            }
+            if (runAt.size() == 6)
+            {
+                scheduler.Stop();
+            }
+        });
+        auto job = ManualScheduler::MakeJob(worker, 10);
+        scheduler.Run(job);
+        CONCURRENCY_CHECK(runAt == std::vector<long long>({0, 10, 20, 75, 80, 90}));
+        CONCURRENCY_CHECK(job.GetMonitor().faults == 1);
+        CONCURRENCY_CHECK(job.GetMonitor().starts == 6);
+    }
+
+    // Failures are counted without stopping the job, and the timeout state reaches the worker.
+    void TestErrorsAndTimeouts()
+    {
+        RecordingWorker throwing;
+        throwing.throws = true;
+        RecordingWorker slow;
+        slow.sleep = std::chrono::milliseconds(5);
+        RecordingWorker quick;
+        SleepScheduler scheduler;
+        auto throwingJob = SleepScheduler::MakeJob(throwing, 1);
+        auto slowJob = SleepScheduler::MakeJob(slow, 10, 1);
+        auto quickJob = SleepScheduler::MakeJob(quick, 10, 1000);
+        scheduler.Start(0, throwingJob, slowJob, quickJob);
+        CONCURRENCY_CHECK(WaitFor([&]() { return throwingJob.GetErrorCount() >= 3 && slow.timeouts.load() >= 2; },
+                                  std::chrono::seconds(5)));
+        scheduler.Stop();
+        CONCURRENCY_CHECK(throwing.runs.load() == static_cast<int>(throwingJob.GetErrorCount()));
+        CONCURRENCY_CHECK(throwing.timeouts.load() == 0 && throwing.inTime.load() == 0);
+        CONCURRENCY_CHECK(slow.inTime.load() == 0);
+        CONCURRENCY_CHECK(quick.timeouts.load() == 0 && quick.inTime.load() == quick.runs.load());
+    }
+} // namespace
+
+int main()
+{
+    TestStartRunsEveryJob();
+    TestMissedSlotsCollapse();
+    TestErrorsAndTimeouts();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,32 @@
+// Stands in for the ConcurrencyLog of the prebuilt library in the tests of headers that only log
+// through it, so those tests also build where the library is not available.
+
+#include <Concurrency/ConcurrencyLog.hpp>
+
+namespace Concurrency
+{
+    ConcurrencyLog::ConcurrencyLog() : sinker(nullptr), started(true)
+    {
+    }
+
+    ConcurrencyLog::~ConcurrencyLog() = default;
+
+    void ConcurrencyLog::RegisterSinker(ILogSinker* sinker)
+    {
+        this->sinker = sinker;
+    }
+
+    void ConcurrencyLog::Log(const LogLevel level, const std::string& message)
+    {
+        if (sinker != nullptr)
+        {
+            sinker->Log(level, message);
+        }
+    }
+
+    ConcurrencyLog& ConcurrencyLog::GetInstance()
+    {
+        static ConcurrencyLog instance;
+        return instance;
+    }
+} // namespace Concurrency
@@ -0,0 +1,70 @@
+// Measures rescheduling the earliest entry of a DeadlineQueue, the operation the PooledScheduler
+// dispatch loop performs for every dispatched job, once as Pop() followed by Push() and once as
+// ReplaceTop(). Header-only, so it builds on every platform. Prints one CSV record per variant
+// and queue size.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include <Concurrency/DeadlineQueue.hpp>
+
+using namespace Concurrency;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+    typedef DeadlineQueue<std::shared_ptr<int>, Clock> Queue;
+
+    const int ROUNDS = 100;
+    const std::size_t QUEUE_SIZES[] = {10000, 100000};
+
+    // Fills a queue with deadlines spread over 100 ms and reschedules its top 50 ms later,
+    // ROUNDS times per entry. Returns the time per 10,000 reschedules in microseconds.
+    template <bool Replace>
+    double Reschedule(std::size_t size)
+    {
+        std::mt19937 random(1);
+        Queue queue;
+        queue.Reserve(size);
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            queue.Push(Clock::time_point(std::chrono::microseconds(random() % 100000)),
+                       std::make_shared<int>(static_cast<int>(index)));
+        }
+
+        const Clock::time_point begin = Clock::now();
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            for (std::size_t index = 0; index < size; ++index)
+            {
+                const Clock::time_point deadline =
+                    queue.TopDeadline() + std::chrono::microseconds(50000 + random() % 1000);
+                if (Replace)
+                {
+                    queue.ReplaceTop(deadline);
+                }
+                else
+                {
+                    std::shared_ptr<int> value = queue.Pop();
+                    queue.Push(deadline, std::move(value));
+                }
+            }
+        }
+        const double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+        return elapsed * 10000.0 / (static_cast<double>(size) * ROUNDS);
+    }
+} // namespace
+
+int main()
+{
+    std::printf("metric,queue_size,value,unit\n");
+    for (const std::size_t size : QUEUE_SIZES)
+    {
+        std::printf("pop_push_per_10k,%zu,%.1f,us\n", size, Reschedule<false>(size));
+        std::printf("replace_top_per_10k,%zu,%.1f,us\n", size, Reschedule<true>(size));
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <Concurrency/DeadlineQueue.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const std::size_t NOT_QUEUED = ~static_cast<std::size_t>(0);
+
+    // The values are indices into a table of positions, which the tracker keeps up to date.
+    std::vector<std::size_t>& Positions()
+    {
+        static std::vector<std::size_t> positions;
+        return positions;
+    }
+
+    struct TablePosition
+    {
+        static void Placed(std::size_t& value, std::size_t index)
+        {
+            Positions()[value] = index;
+        }
+
+        static void Removed(std::size_t& value)
+        {
+            Positions()[value] = NOT_QUEUED;
+        }
+    };
+
+    typedef DeadlineQueue<std::size_t, Clock, TablePosition> TrackedQueue;
+
+    Clock::time_point At(long microseconds)
+    {
+        return Clock::time_point(std::chrono::microseconds(microseconds));
+    }
+
+    void TestPopsInDeadlineOrder()
+    {
+        DeadlineQueue<int, Clock> queue;
+        CONCURRENCY_CHECK(queue.Push(At(30), 3));
+        CONCURRENCY_CHECK(queue.Push(At(10), 1));
+        CONCURRENCY_CHECK(!queue.Push(At(20), 2));
+        queue.ReplaceTop(At(40));
+        CONCURRENCY_CHECK(queue.Size() == 3);
+        CONCURRENCY_CHECK(queue.Pop() == 2);
+        CONCURRENCY_CHECK(queue.Pop() == 3);
+        CONCURRENCY_CHECK(queue.TopDeadline() == At(40) && queue.Pop() == 1);
+        CONCURRENCY_CHECK(queue.Empty());
+    }
+
+    // Moving and removing entries by their tracked index keeps the heap ordered and every
+    // position current.
+    void TestTrackedUpdateAndErase()
+    {
+        const std::size_t count = 1000;
+        std::mt19937 random(1);
+        std::vector<long> deadline(count);
+        Positions().assign(count, NOT_QUEUED);
+        TrackedQueue queue;
+        for (std::size_t value = 0; value < count; ++value)
+        {
+            deadline[value] = static_cast<long>(random() % 100000);
+            queue.Push(At(deadline[value]), value);
+        }
+
+        bool tracked = true;
+        for (std::size_t step = 0; step < 5000; ++step)
+        {
+            const std::size_t value = random() % count;
+            const std::size_t index = Positions()[value];
+            if (index == NOT_QUEUED)
+            {
+                deadline[value] = static_cast<long>(random() % 100000);
+                queue.Push(At(deadline[value]), value);
+            }
+            else if (step % 4 == 0)
+            {
+                tracked = tracked && queue.Erase(index) == value;
+            }
+            else
+            {
+                deadline[value] = static_cast<long>(random() % 100000);
+                queue.Update(index, At(deadline[value]));
+            }
+            const std::size_t moved = Positions()[value];
+            tracked = tracked && (moved == NOT_QUEUED || queue.DeadlineAt(moved) == At(deadline[value]));
+        }
+        CONCURRENCY_CHECK(tracked);
+
+        bool ordered = true;
+        Clock::time_point previous = At(0);
+        while (!queue.Empty())
+        {
+            const Clock::time_point top = queue.TopDeadline();
+            const std::size_t value = queue.Pop();
+            ordered = ordered && previous <= top && top == At(deadline[value]) && Positions()[value] == NOT_QUEUED;
+            previous = top;
+        }
+        CONCURRENCY_CHECK(ordered);
+    }
+} // namespace
+
+int main()
+{
+    TestPopsInDeadlineOrder();
+    TestTrackedUpdateAndErase();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,188 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#include <Concurrency/InplaceFunction.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    std::atomic<int> allocations(0);
+}
+
+// Counts every allocation of the program, so the tests can tell inline targets from heap ones.
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+    // Counts how many of its instances are alive.
+    struct Counted
+    {
+        explicit Counted(int* alive) : alive(alive)
+        {
+            ++*alive;
+        }
+
+        Counted(Counted&& other) noexcept : alive(other.alive)
+        {
+            ++*alive;
+        }
+
+        Counted(const Counted& other) : alive(other.alive)
+        {
+            ++*alive;
+        }
+
+        ~Counted()
+        {
+            --*alive;
+        }
+
+        int operator()(int value) const
+        {
+            return value + 1;
+        }
+
+        int* alive;
+    };
+
+    struct Large
+    {
+        Counted counted;
+        char padding[128];
+
+        int operator()(int value) const
+        {
+            return counted(value) * 2;
+        }
+    };
+
+    // A callable whose move constructor may throw cannot be stored inline.
+    struct ThrowingMove
+    {
+        ThrowingMove() = default;
+        ThrowingMove(ThrowingMove&&) noexcept(false)
+        {
+        }
+
+        int operator()(int value) const
+        {
+            return value;
+        }
+    };
+
+    typedef InplaceFunction<int(int)> Function;
+    typedef InplaceFunction<int(int), 96> LargerFunction;
+    typedef InplaceFunction<int(int), 48, true> HeapFunction;
+
+    void TestInlineTargetNeverAllocates()
+    {
+        int alive = 0;
+        const int before = allocations.load();
+        {
+            Function function(Counted{&alive});
+            Function moved(std::move(function));
+            Function assigned;
+            assigned = std::move(moved);
+            CONCURRENCY_CHECK(assigned(1) == 2);
+            CONCURRENCY_CHECK(alive == 1);
+        }
+        CONCURRENCY_CHECK(allocations.load() == before);
+        CONCURRENCY_CHECK(alive == 0);
+        CONCURRENCY_CHECK(Function::FitsInline<Counted>());
+    }
+
+    // A moved-from wrapper is empty, and assigning nullptr destroys the target.
+    void TestMoveEmptiesTheSource()
+    {
+        int alive = 0;
+        Function function(Counted{&alive});
+        CONCURRENCY_CHECK(static_cast<bool>(function));
+        Function moved(std::move(function));
+        CONCURRENCY_CHECK(!function && moved && alive == 1);
+        Function assigned;
+        assigned = std::move(moved);
+        CONCURRENCY_CHECK(!moved && assigned(41) == 42 && alive == 1);
+        assigned = nullptr;
+        CONCURRENCY_CHECK(!assigned && alive == 0);
+        Function empty(nullptr);
+        CONCURRENCY_CHECK(!empty);
+    }
+
+    // A wrapper converts into a larger one, and an inline one into one allowed to use the heap.
+    void TestConversions()
+    {
+        int alive = 0;
+        Function small(Counted{&alive});
+        LargerFunction larger(std::move(small));
+        CONCURRENCY_CHECK(!small && larger(1) == 2 && alive == 1);
+
+        Function inlined(Counted{&alive});
+        HeapFunction heap(std::move(inlined));
+        CONCURRENCY_CHECK(!inlined && heap(2) == 3 && alive == 2);
+        larger = nullptr;
+        heap = nullptr;
+        CONCURRENCY_CHECK(alive == 0);
+    }
+
+    // A target too large to fit lives on the heap and is destroyed exactly once, wherever it moved.
+    void TestHeapFallback()
+    {
+        int alive = 0;
+        CONCURRENCY_CHECK(!HeapFunction::FitsInline<Large>());
+        {
+            const int before = allocations.load();
+            HeapFunction function(Large{Counted{&alive}, {}});
+            CONCURRENCY_CHECK(allocations.load() == before + 1);
+            HeapFunction moved(std::move(function));
+            InplaceFunction<int(int), 64, true> converted(std::move(moved));
+            CONCURRENCY_CHECK(allocations.load() == before + 1);
+            CONCURRENCY_CHECK(!function && !moved && converted(1) == 4 && alive == 1);
+        }
+        CONCURRENCY_CHECK(alive == 0);
+    }
+
+    // Without AllowHeap, constructing a Function from ThrowingMove is a compile error; with it,
+    // the callable goes to the heap.
+    void TestThrowingMoveUsesTheHeap()
+    {
+        CONCURRENCY_CHECK(!Function::FitsInline<ThrowingMove>());
+        const int before = allocations.load();
+        HeapFunction function{ThrowingMove()};
+        CONCURRENCY_CHECK(allocations.load() == before + 1 && function(7) == 7);
+    }
+} // namespace
+
+int main()
+{
+    TestInlineTargetNeverAllocates();
+    TestMoveEmptiesTheSource();
+    TestConversions();
+    TestHeapFallback();
+    TestThrowingMoveUsesTheHeap();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,121 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include <Concurrency/LatencyHistogram.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    typedef LatencyHistogram<> Histogram;
+
+    // Every value maps to a bucket whose highest value is above it by less than the relative error,
+    // and the buckets increase with the values.
+    template <typename Tested>
+    bool BucketsBoundTheError(uint64_t value, std::size_t& previousIndex, uint64_t precisionDivisor)
+    {
+        const std::size_t index = Tested::BucketIndex(value);
+        const uint64_t highest = Tested::HighestEquivalentValue(index);
+        const bool bounded =
+            index < Tested::BUCKET_COUNT && highest >= value && highest - value <= value / precisionDivisor;
+        const bool ordered = index >= previousIndex;
+        previousIndex = index;
+        return bounded && ordered;
+    }
+
+    void TestBucketPrecision()
+    {
+        bool precise = true;
+        std::size_t previous = 0;
+        for (uint64_t value = 0; value < 100000; ++value)
+        {
+            precise = precise && BucketsBoundTheError<Histogram>(value, previous, 32);
+        }
+        std::mt19937_64 random(1);
+        for (int sample = 0; sample < 100000; ++sample)
+        {
+            std::size_t unordered = 0;
+            precise = precise && BucketsBoundTheError<Histogram>(random() & Histogram::MAX_VALUE, unordered, 32);
+        }
+        CONCURRENCY_CHECK(precise);
+        CONCURRENCY_CHECK(Histogram::BucketIndex(Histogram::MAX_VALUE) == Histogram::BUCKET_COUNT - 1);
+
+        typedef LatencyHistogram<2, 8> Coarse;
+        bool coarse = true;
+        previous = 0;
+        for (uint64_t value = 0; value <= Coarse::MAX_VALUE; ++value)
+        {
+            coarse = coarse && BucketsBoundTheError<Coarse>(value, previous, 2);
+        }
+        CONCURRENCY_CHECK(coarse);
+        CONCURRENCY_CHECK(Coarse::BucketIndex(Coarse::MAX_VALUE) == Coarse::BUCKET_COUNT - 1);
+    }
+
+    void TestPercentiles()
+    {
+        Histogram histogram;
+        CONCURRENCY_CHECK(histogram.GetValueAtPercentile(50.0) == 0 && histogram.GetMaxValue() == 0);
+        for (uint64_t value = 0; value < 64; ++value)
+        {
+            histogram.Record(value);
+        }
+        CONCURRENCY_CHECK(histogram.GetValueAtPercentile(50.0) == 31);
+        CONCURRENCY_CHECK(histogram.GetValueAtPercentile(0.0) == 0);
+        CONCURRENCY_CHECK(histogram.GetMaxValue() == 63);
+
+        histogram.Reset();
+        for (uint64_t value = 1; value <= 10000; ++value)
+        {
+            histogram.Record(value);
+        }
+        const uint64_t median = histogram.GetValueAtPercentile(50.0);
+        const uint64_t tail = histogram.GetValueAtPercentile(99.9);
+        CONCURRENCY_CHECK(histogram.GetTotalCount() == 10000);
+        CONCURRENCY_CHECK(median >= 5000 && median <= 5000 + 5000 / 32);
+        CONCURRENCY_CHECK(tail >= 9990 && tail <= 9990 + 9990 / 32);
+        CONCURRENCY_CHECK(histogram.GetValueAtPercentile(100.0) == histogram.GetMaxValue());
+        CONCURRENCY_CHECK(histogram.GetValueAtPercentile(250.0) == histogram.GetMaxValue());
+
+        histogram.Record(Histogram::MAX_VALUE + 1000);
+        CONCURRENCY_CHECK(histogram.GetMaxValue() == Histogram::MAX_VALUE);
+    }
+
+    // Each window holds what was recorded since the previous one, while the live histogram keeps every value.
+    void TestWindows()
+    {
+        Histogram live;
+        LatencyWindow<Histogram> window;
+        for (int sample = 0; sample < 100; ++sample)
+        {
+            live.Record(10);
+        }
+        const Histogram& first = window.Advance(live);
+        CONCURRENCY_CHECK(first.GetTotalCount() == 100 && first.GetMaxValue() == 10);
+
+        for (int sample = 0; sample < 5; ++sample)
+        {
+            live.Record(1000);
+        }
+        const Histogram& second = window.Advance(live);
+        CONCURRENCY_CHECK(second.GetTotalCount() == 5);
+        CONCURRENCY_CHECK(second.GetValueAtPercentile(0.0) >= 1000);
+        CONCURRENCY_CHECK(window.Advance(live).GetTotalCount() == 0);
+        CONCURRENCY_CHECK(live.GetTotalCount() == 105);
+
+        Histogram sum;
+        sum.Add(live);
+        sum.Add(live);
+        CONCURRENCY_CHECK(sum.GetTotalCount() == 210 && sum.GetValueAtPercentile(50.0) == 10);
+    }
+} // namespace
+
+int main()
+{
+    TestBucketPrecision();
+    TestPercentiles();
+    TestWindows();
+    return ConcurrencyTest::Result();
+}
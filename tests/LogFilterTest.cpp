@@ -0,0 +1,104 @@
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Concurrency/LogFilter.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    class RecordingSinker : public ILogSinker
+    {
+    public:
+        void Log(const LogLevel level, const std::string& message) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            levels.push_back(level);
+            messages.push_back(message);
+        }
+
+        std::size_t GetCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return messages.size();
+        }
+
+        std::mutex mutex;
+        std::vector<LogLevel> levels;
+        std::vector<std::string> messages;
+    };
+
+    RecordingSinker sinker;
+
+    // Builds the message of a Log() call and counts how many times it was asked to.
+    std::string CountedMessage(int& calls, const char* message)
+    {
+        ++calls;
+        return message;
+    }
+
+    // A message below the runtime minimum is never built, and one at or above it is built once.
+    void TestFormatterOnlyCalledWhenEnabled()
+    {
+        LogFilter::SetMinimumLevel(LogLevel::Warning);
+        CONCURRENCY_CHECK(LogFilter::GetMinimumLevel() == LogLevel::Warning);
+        CONCURRENCY_CHECK(!LogFilter::IsEnabled(LogLevel::Info));
+        const std::size_t before = sinker.GetCount();
+        int calls = 0;
+        LogFilter::Log<LogLevel::Info>([&calls]() { return CountedMessage(calls, "filtered"); });
+        LogFilter::Log<LogLevel::Debug>([&calls]() { return CountedMessage(calls, "filtered"); });
+        LogFilter::Format<LogLevel::Info>("filtered %d", 1);
+        LogFilter::Log(LogLevel::Info, "filtered");
+        CONCURRENCY_CHECK(calls == 0);
+
+        LogFilter::Log<LogLevel::Error>([&calls]() { return CountedMessage(calls, "passed"); });
+        CONCURRENCY_CHECK(calls == 1);
+        CONCURRENCY_CHECK(WaitFor([before]() { return sinker.GetCount() == before + 1; }, std::chrono::seconds(5)));
+        std::lock_guard<std::mutex> lock(sinker.mutex);
+        CONCURRENCY_CHECK(sinker.messages.back() == "passed" && sinker.levels.back() == LogLevel::Error);
+    }
+
+    // Format() forwards the formatted text, also when it does not fit the stack buffer.
+    void TestFormatForwardsText()
+    {
+        LogFilter::SetMinimumLevel(LogLevel::Warning);
+        const std::size_t before = sinker.GetCount();
+        LogFilter::Format<LogLevel::Warning>("job %s overran by %d us", "poll", 250);
+        const std::string longText(LogFilter::FORMAT_BUFFER_SIZE * 2, 'x');
+        LogFilter::Format<LogLevel::Error>("[%s]", longText.c_str());
+        LogFilter::Format<LogLevel::Warning>("plain");
+        CONCURRENCY_CHECK(WaitFor([before]() { return sinker.GetCount() == before + 3; }, std::chrono::seconds(5)));
+        std::lock_guard<std::mutex> lock(sinker.mutex);
+        CONCURRENCY_CHECK(sinker.messages[before] == "job poll overran by 250 us");
+        CONCURRENCY_CHECK(sinker.levels[before] == LogLevel::Warning);
+        CONCURRENCY_CHECK(sinker.messages[before + 1] == "[" + longText + "]");
+        CONCURRENCY_CHECK(sinker.messages[before + 2] == "plain");
+    }
+
+    // Levels below CONCURRENCY_LOG_COMPILED_LEVEL are never built, whatever the runtime minimum.
+    // This file is also built as LogFilterCompiledOutTest, compiling Info and below out.
+    void TestCompiledOutLevels()
+    {
+        LogFilter::SetMinimumLevel(LogLevel::Trace);
+        int calls = 0;
+        LogFilter::Log<LogLevel::Info>([&calls]() { return CountedMessage(calls, "info"); });
+        CONCURRENCY_CHECK(calls == (LogFilter::IsCompiled(LogLevel::Info) ? 1 : 0));
+        CONCURRENCY_CHECK(LogFilter::IsEnabled(LogLevel::Info) == LogFilter::IsCompiled(LogLevel::Info));
+        CONCURRENCY_CHECK(LogFilter::IsCompiled(LogLevel::Error));
+    }
+} // namespace
+
+int main()
+{
+    ConcurrencyLog::GetInstance().RegisterSinker(&sinker);
+    TestFormatterOnlyCalledWhenEnabled();
+    TestFormatForwardsText();
+    TestCompiledOutLevels();
+    ConcurrencyLog::GetInstance().RegisterSinker(nullptr);
+    return ConcurrencyTest::Result();
+}
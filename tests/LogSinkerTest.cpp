@@ -0,0 +1,164 @@
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Concurrency/AsyncLogSinker.hpp>
+#include <Concurrency/MultiLogSinker.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    class RecordingSinker : public ILogSinker
+    {
+    public:
+        void Log(const LogLevel level, const std::string& message) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            levels.push_back(level);
+            messages.push_back(message);
+        }
+
+        std::mutex mutex;
+        std::vector<LogLevel> levels;
+        std::vector<std::string> messages;
+    };
+
+    class RecordingBatchSinker : public IBatchLogSinker
+    {
+    public:
+        using IBatchLogSinker::LogBatch;
+
+        RecordingBatchSinker() : batches(0)
+        {
+        }
+
+        void LogBatch(const LogRecord* records, std::size_t count) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++batches;
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                levels.push_back(records[index].level);
+                messages.emplace_back(records[index].message, records[index].length);
+            }
+        }
+
+        std::mutex mutex;
+        std::size_t batches;
+        std::vector<LogLevel> levels;
+        std::vector<std::string> messages;
+    };
+
+    LogRecord Record(LogLevel level, const char* message)
+    {
+        return LogRecord{level, message, std::char_traits<char>::length(message)};
+    }
+
+    // Every sinker receives the messages reaching its level, a batch sinker as whole batches.
+    void TestMultiFiltersByLevel()
+    {
+        RecordingSinker all;
+        RecordingBatchSinker warnings;
+        MultiLogSinker multi;
+        multi.Add(all);
+        multi.Add(warnings, LogLevel::Warning);
+
+        const LogRecord records[] = {Record(LogLevel::Info, "info"), Record(LogLevel::Error, "error"),
+                                     Record(LogLevel::Debug, "debug"), Record(LogLevel::Warning, "warning")};
+        multi.LogBatch(records, 4);
+        multi.Log(LogLevel::Trace, "trace");
+        CONCURRENCY_CHECK(all.messages == std::vector<std::string>({"info", "error", "debug", "warning", "trace"}));
+        CONCURRENCY_CHECK(warnings.messages == std::vector<std::string>({"error", "warning"}));
+        CONCURRENCY_CHECK(warnings.batches == 1);
+
+        CONCURRENCY_CHECK(multi.Remove(warnings));
+        CONCURRENCY_CHECK(!multi.Remove(warnings));
+        multi.Log(LogLevel::Error, "removed");
+        CONCURRENCY_CHECK(warnings.messages.size() == 2 && all.messages.size() == 6);
+    }
+
+    // A filtered batch longer than the filter buffer still arrives complete and in order.
+    void TestMultiForwardsLongBatches()
+    {
+        RecordingBatchSinker errors;
+        MultiLogSinker multi;
+        multi.Add(errors, LogLevel::Error);
+        std::vector<LogRecord> records;
+        for (int index = 0; index < 300; ++index)
+        {
+            records.push_back(Record(index % 2 == 0 ? LogLevel::Error : LogLevel::Info, index % 2 == 0 ? "e" : "i"));
+        }
+        multi.LogBatch(records.data(), records.size());
+        CONCURRENCY_CHECK(errors.messages.size() == 150);
+        CONCURRENCY_CHECK(errors.levels.back() == LogLevel::Error);
+    }
+
+#if defined(__cpp_lib_span)
+    // The span overload stays callable on sinkers that override the pointer overload.
+    void TestSpanOverload()
+    {
+        RecordingBatchSinker target;
+        MultiLogSinker multi;
+        multi.Add(target);
+        const LogRecord records[] = {Record(LogLevel::Info, "first"), Record(LogLevel::Info, "second")};
+        multi.LogBatch(std::span<const LogRecord>(records));
+        target.LogBatch(std::span<const LogRecord>(records, 1));
+        CONCURRENCY_CHECK(target.messages == std::vector<std::string>({"first", "second", "first"}));
+    }
+#endif
+
+    // Messages arrive in the order they were logged, in batches, and truncated to the record size.
+    void TestAsyncDeliversInOrder()
+    {
+        const int count = 1000;
+        RecordingBatchSinker target;
+        {
+            AsyncLogSinker async(target, 16, LogOverflowPolicy::Block);
+            for (int index = 0; index < count; ++index)
+            {
+                async.Log(LogLevel::Info, std::to_string(index));
+            }
+            async.Log(LogLevel::Error, std::string(AsyncLogSinker::MESSAGE_CAPACITY * 2, 'x'));
+            async.Flush();
+            CONCURRENCY_CHECK(target.messages.size() == count + 1);
+            CONCURRENCY_CHECK(async.GetDroppedCount() == 0);
+        }
+        bool ordered = true;
+        for (int index = 0; index < count; ++index)
+        {
+            ordered = ordered && target.messages[index] == std::to_string(index);
+        }
+        CONCURRENCY_CHECK(ordered);
+        CONCURRENCY_CHECK(target.messages.back().size() == AsyncLogSinker::MESSAGE_CAPACITY);
+        CONCURRENCY_CHECK(target.levels.back() == LogLevel::Error);
+        CONCURRENCY_CHECK(target.batches <= static_cast<std::size_t>(count));
+    }
+
+    // A sinker without batch support behind the queue receives every message on its own.
+    void TestAsyncToPlainSinker()
+    {
+        RecordingSinker target;
+        {
+            AsyncLogSinker async(target);
+            async.Log(LogLevel::Warning, "one");
+            async.Log(LogLevel::Info, "two", 2);
+        }
+        CONCURRENCY_CHECK(target.messages == std::vector<std::string>({"one", "tw"}));
+    }
+} // namespace
+
+int main()
+{
+    TestMultiFiltersByLevel();
+    TestMultiForwardsLongBatches();
+#if defined(__cpp_lib_span)
+    TestSpanOverload();
+#endif
+    TestAsyncDeliversInOrder();
+    TestAsyncToPlainSinker();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/NativeThread.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    // Runs a check on a thread of its own, so that names, affinities and priorities do not stick to main.
+    template <typename Check>
+    void OnNewThread(Check check)
+    {
+        std::thread thread(check);
+        thread.join();
+    }
+
+    void TestParseProcessorList()
+    {
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("0") == std::vector<uint32_t>({0}));
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("0-3,8,10-11\n") ==
+                          std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}));
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("64-65,1") == std::vector<uint32_t>({64, 65, 1}));
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("").empty());
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("\n").empty());
+        CONCURRENCY_CHECK(ThisThread::ParseProcessorList("2,5-3,7") == std::vector<uint32_t>({2}));
+    }
+
+    // The processor time of the calling thread grows while it spins.
+    void TestCpuUsageGrows()
+    {
+        ThreadCpuUsage before;
+        ThreadCpuUsage after;
+        CONCURRENCY_CHECK(ThisThread::GetCpuUsage(before));
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+        volatile uint64_t spins = 0;
+        while (std::chrono::steady_clock::now() < until)
+        {
+            spins = spins + 1;
+        }
+        CONCURRENCY_CHECK(ThisThread::GetCpuUsage(after));
+        CONCURRENCY_CHECK(after.cpuTime > before.cpuTime);
+        CONCURRENCY_CHECK(after.voluntarySwitches >= before.voluntarySwitches);
+    }
+
+#if defined(__linux__)
+    std::string GetName()
+    {
+        char name[16] = {};
+        ::pthread_getname_np(::pthread_self(), name, sizeof(name));
+        return name;
+    }
+
+    // Names longer than the 15 characters of Linux keep their "-index" suffix.
+    void TestSetNameTruncates()
+    {
+        OnNewThread([]() {
+            ThisThread::SetName("Pool");
+            CONCURRENCY_CHECK(GetName() == "Pool");
+            ThisThread::SetName("PooledScheduler-12");
+            CONCURRENCY_CHECK(GetName() == "PooledSchedu-12");
+            ThisThread::SetName("AVeryLongThreadNameWithoutIndex");
+            CONCURRENCY_CHECK(GetName() == "AVeryLongThread");
+            ThisThread::SetName("Pool-averyveryverylongsuffix");
+            CONCURRENCY_CHECK(GetName() == "Pool-averyveryv");
+        });
+    }
+
+    void TestSetAffinity()
+    {
+        OnNewThread([]() {
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            CONCURRENCY_CHECK(::sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+            uint32_t processor = 0;
+            while (processor < CPU_SETSIZE && !CPU_ISSET(processor, &allowed))
+            {
+                ++processor;
+            }
+            CONCURRENCY_CHECK(!ThisThread::SetAffinity(std::vector<uint32_t>()));
+            CONCURRENCY_CHECK(ThisThread::SetAffinity(std::vector<uint32_t>({processor})));
+            cpu_set_t applied;
+            CPU_ZERO(&applied);
+            CONCURRENCY_CHECK(::sched_getaffinity(0, sizeof(applied), &applied) == 0);
+            CONCURRENCY_CHECK(CPU_COUNT(&applied) == 1 && CPU_ISSET(processor, &applied));
+        });
+    }
+
+    void TestNumaNodeProcessors()
+    {
+        const std::vector<uint32_t> processors = ThisThread::GetNumaNodeProcessors(0);
+        CONCURRENCY_CHECK(!processors.empty());
+        CONCURRENCY_CHECK(ThisThread::GetNumaNodeProcessors(100000).empty());
+    }
+
+    // Levels below normal become nice values of five per level, for the calling thread only.
+    void TestSetPriorityNice()
+    {
+        OnNewThread([]() {
+            CONCURRENCY_CHECK(ThisThread::SetPriority(-2));
+            CONCURRENCY_CHECK(::getpriority(PRIO_PROCESS, static_cast<id_t>(ThisThread::GetId())) == 10);
+        });
+        CONCURRENCY_CHECK(::getpriority(PRIO_PROCESS, static_cast<id_t>(ThisThread::GetId())) != 10);
+        CONCURRENCY_CHECK(ThisThread::GetId() == static_cast<uint64_t>(::syscall(SYS_gettid)));
+    }
+#endif
+} // namespace
+
+int main()
+{
+    TestParseProcessorList();
+    TestCpuUsageGrows();
+#if defined(__linux__)
+    TestSetNameTruncates();
+    TestSetAffinity();
+    TestNumaNodeProcessors();
+    TestSetPriorityNice();
+#endif
+    return ConcurrencyTest::Result();
+}
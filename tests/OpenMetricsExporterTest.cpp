@@ -0,0 +1,118 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Concurrency/OpenMetricsExporter.hpp>
+#include <Concurrency/PooledScheduler.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    std::vector<std::string> Lines(const std::string& text)
+    {
+        std::vector<std::string> lines;
+        std::istringstream stream(text);
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    bool Contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    // Every sample is a metric name, a label set and an unsigned value.
+    bool IsWellFormedSample(const std::string& line)
+    {
+        const std::size_t labels = line.find("{job=\"");
+        const std::size_t value = line.rfind("} ");
+        if (labels == std::string::npos || value == std::string::npos || value + 2 == line.size())
+        {
+            return false;
+        }
+        return line.find_first_not_of("0123456789", value + 2) == std::string::npos;
+    }
+
+    // The families, units, escaped labels and summaries of an exposition, closed by the EOF marker.
+    void TestExposition()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        std::vector<JobSpec> specs;
+        specs.push_back(JobSpec("say \"hi\"\n", [&runs]() { runs.fetch_add(1); }, 2, 0));
+        specs.back().latencyHistograms = true;
+        specs.push_back(JobSpec("plain", []() {}, 2, 0));
+        scheduler.AttachBatch(std::move(specs));
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 5; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+
+        OpenMetricsExporter exporter("test_job");
+        std::ostringstream stream;
+        CONCURRENCY_CHECK(exporter.Write(scheduler, stream) == 2);
+        const std::string text = stream.str();
+        const std::string escaped = "{job=\"say \\\"hi\\\"\\n\"";
+
+        CONCURRENCY_CHECK(text.size() >= 6 && text.compare(text.size() - 6, 6, "# EOF\n") == 0);
+        CONCURRENCY_CHECK(Contains(text, "# TYPE test_job_runs counter\n"));
+        CONCURRENCY_CHECK(Contains(text, "# TYPE test_job_duration_max_microseconds gauge\n"));
+        CONCURRENCY_CHECK(Contains(text, "# UNIT test_job_duration_max_microseconds microseconds\n"));
+        CONCURRENCY_CHECK(Contains(text, "test_job_runs_total" + escaped + "} "));
+        CONCURRENCY_CHECK(Contains(text, "test_job_runs_total{job=\"plain\"} "));
+        CONCURRENCY_CHECK(Contains(text, "test_job_interval_expected_microseconds{job=\"plain\"} 2000\n"));
+        CONCURRENCY_CHECK(Contains(text, "test_job_duration_microseconds" + escaped + ",quantile=\"0.999\"} "));
+        CONCURRENCY_CHECK(Contains(text, "test_job_interval_microseconds_count" + escaped + "} "));
+        CONCURRENCY_CHECK(!Contains(text, "test_job_duration_microseconds{job=\"plain\""));
+        CONCURRENCY_CHECK(!Contains(text, "test_job_cpu_time_microseconds_total{"));
+
+        int samples = 0;
+        bool wellFormed = true;
+        for (const std::string& line : Lines(text))
+        {
+            if (line.compare(0, 1, "#") != 0)
+            {
+                ++samples;
+                wellFormed = wellFormed && line.compare(0, 9, "test_job_") == 0 && IsWellFormedSample(line);
+            }
+        }
+        CONCURRENCY_CHECK(wellFormed);
+        // Eleven families per job, and two summaries of three quantiles and a count for one of them.
+        CONCURRENCY_CHECK(samples == 11 * 2 + 2 * 4);
+    }
+
+    // A later scrape reuses the rows of the previous one and only exports the jobs still attached.
+    void TestRescrapeAfterDetach()
+    {
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("first", []() {}, 5, 0);
+        scheduler.Attach("second", []() {}, 5, 0);
+        OpenMetricsExporter exporter;
+        std::ostringstream first;
+        CONCURRENCY_CHECK(exporter.Write(scheduler, first) == 2);
+        CONCURRENCY_CHECK(Contains(first.str(), "concurrency_job_runs_total{job=\"second\"} 0\n"));
+
+        CONCURRENCY_CHECK(scheduler.Detach("second"));
+        std::ostringstream second;
+        CONCURRENCY_CHECK(exporter.Write(scheduler, second) == 1);
+        CONCURRENCY_CHECK(Contains(second.str(), "{job=\"first\"}"));
+        CONCURRENCY_CHECK(!Contains(second.str(), "{job=\"second\"}"));
+    }
+} // namespace
+
+int main()
+{
+    TestExposition();
+    TestRescrapeAfterDetach();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,161 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Concurrency/ParallelFor.hpp>
+#include <Concurrency/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    void TestEmptyRange()
+    {
+        ThreadPool pool(2);
+        pool.Start();
+        std::atomic<int> calls(0);
+        ParallelFor(&pool, 5, 5, 0, [&calls](std::size_t) { calls.fetch_add(1); });
+        ParallelFor(&pool, 7, 3, 1, [&calls](std::size_t) { calls.fetch_add(1); });
+        CONCURRENCY_CHECK(calls.load() == 0);
+        const int sum = ParallelReduce(
+            &pool, 5, 5, 0, 42, [](std::size_t) { return 1; }, [](int left, int right) { return left + right; });
+        CONCURRENCY_CHECK(sum == 42);
+        pool.Stop();
+    }
+
+    // Every index is visited exactly once, whether the range is one chunk or many.
+    void TestEveryIndexOnce()
+    {
+        const std::size_t count = 1000;
+        ThreadPool pool(4);
+        pool.Start();
+        for (const std::size_t grain : {std::size_t(0), std::size_t(1), std::size_t(7), count, count * 10})
+        {
+            std::vector<std::atomic<int>> seen(count);
+            ParallelFor(&pool, 0, count, grain, [&seen](std::size_t index) { seen[index].fetch_add(1); });
+            int wrong = 0;
+            for (const std::atomic<int>& times : seen)
+            {
+                wrong += times.load() != 1;
+            }
+            CONCURRENCY_CHECK(wrong == 0);
+        }
+        std::atomic<int> calls(0);
+        ParallelFor(nullptr, 10, 20, 3, [&calls](std::size_t) { calls.fetch_add(1); });
+        CONCURRENCY_CHECK(calls.load() == 10);
+        pool.Stop();
+    }
+
+    // The chunks are combined in the order of the range, and bool partials do not share storage.
+    void TestReduceCombinesInOrder()
+    {
+        ThreadPool pool(4);
+        pool.Start();
+        const std::string digits = ParallelReduce(
+            &pool, 0, 10, 1, std::string(), [](std::size_t index) { return std::to_string(index); },
+            [](std::string left, const std::string& right) { return left + right; });
+        CONCURRENCY_CHECK(digits == "0123456789");
+
+        const uint64_t sum = ParallelReduce(
+            &pool, 1, 100001, 64, uint64_t(0), [](std::size_t index) { return uint64_t(index); },
+            [](uint64_t left, uint64_t right) { return left + right; });
+        CONCURRENCY_CHECK(sum == uint64_t(100000) * 100001 / 2);
+
+        const bool any = ParallelReduce(
+            &pool, 0, 10000, 16, false, [](std::size_t index) { return index == 9999; },
+            [](bool left, bool right) { return left || right; });
+        const bool all = ParallelReduce(
+            &pool, 0, 10000, 16, true, [](std::size_t index) { return index != 5000; },
+            [](bool left, bool right) { return left && right; });
+        CONCURRENCY_CHECK(any);
+        CONCURRENCY_CHECK(!all);
+        pool.Stop();
+    }
+
+    // The first exception is rethrown on the calling thread, and the pool keeps working afterwards.
+    void TestExceptionIsRethrown()
+    {
+        ThreadPool pool(4);
+        pool.Start();
+        bool thrown = false;
+        try
+        {
+            ParallelFor(&pool, 0, 1000, 10, [](std::size_t index) {
+                if (index == 500)
+                {
+                    throw std::runtime_error("index");
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CONCURRENCY_CHECK(thrown);
+
+        thrown = false;
+        try
+        {
+            ParallelReduce(
+                &pool, 0, 100, 1, 0,
+                [](std::size_t index) -> int {
+                    if (index == 50)
+                    {
+                        throw std::runtime_error("index");
+                    }
+                    return 1;
+                },
+                [](int left, int right) { return left + right; });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CONCURRENCY_CHECK(thrown);
+
+        std::atomic<int> calls(0);
+        ParallelFor(&pool, 0, 100, 1, [&calls](std::size_t) { calls.fetch_add(1); });
+        CONCURRENCY_CHECK(calls.load() == 100);
+        pool.Stop();
+    }
+
+    // Loops started from pool threads, nested inside other loops, complete even when every
+    // thread of the pool is waiting in one of them.
+    void TestNestedFromPoolThread()
+    {
+        const std::size_t outer = 16;
+        const std::size_t inner = 100;
+        ThreadPool pool(2);
+        pool.Start();
+        std::atomic<uint64_t> total(0);
+        std::atomic<bool> done(false);
+        pool.Submit([&]() {
+            ParallelFor(0, outer, 1, [&](std::size_t) {
+                total.fetch_add(ParallelReduce(
+                    0, inner, 8, uint64_t(0), [](std::size_t) { return uint64_t(1); },
+                    [](uint64_t left, uint64_t right) { return left + right; }));
+            });
+            done.store(true);
+        });
+        CONCURRENCY_CHECK(WaitFor([&done]() { return done.load(); }, std::chrono::seconds(10)));
+        CONCURRENCY_CHECK(total.load() == outer * inner);
+        pool.Stop();
+    }
+} // namespace
+
+int main()
+{
+    TestEmptyRange();
+    TestEveryIndexOnce();
+    TestReduceCombinesInOrder();
+    TestExceptionIsRethrown();
+    TestNestedFromPoolThread();
+    return ConcurrencyTest::Result();
+}
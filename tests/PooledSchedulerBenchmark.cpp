@@ -0,0 +1,357 @@
+// Measures PooledScheduler for the metrics of the "Measuring Performance" section of the README,
+// for every pool size from 1 to the number of hardware threads, and the interval jitter and
+// dispatch cost of Scheduler, which runs every CyclicalWorker on a thread of its own, as the
+// baseline. Prints one CSV record per metric and pool size, pool size 0 for Scheduler, so runs of
+// different releases can be compared line by line.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/LatencyHistogram.hpp>
+#include <Concurrency/PooledScheduler.hpp>
+#include <Concurrency/Scheduler.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace Concurrency;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const int WAKEUP_SAMPLES = 2000;
+    const int SUBMIT_COUNT = 100000;
+    const std::size_t ATTACH_BATCHES[] = {1, 100, 10000};
+    const std::size_t JOB_COUNTS[] = {1, 100, 1000, 10000};
+    // Scheduler starts one thread per job, so it is not driven beyond this number of jobs.
+    const std::size_t SCHEDULER_MAX_JOBS = 1000;
+
+    void Print(const char* metric, uint32_t poolSize, double value, const char* unit)
+    {
+        std::printf("%s,%u,%.3f,%s\n", metric, poolSize, value, unit);
+    }
+
+    double Microseconds(Clock::duration elapsed)
+    {
+        return std::chrono::duration<double, std::micro>(elapsed).count();
+    }
+
+    // The processor time of the whole process in microseconds.
+    double ProcessCpuMicroseconds()
+    {
+#if defined(_WIN32)
+        FILETIME creation, exit, kernel, user;
+        ::GetProcessTimes(::GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        const auto ticks = [](const FILETIME& time) {
+            return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        return (ticks(kernel) + ticks(user)) / 10.0;
+#else
+        return static_cast<double>(std::clock()) * 1000000.0 / CLOCKS_PER_SEC;
+#endif
+    }
+
+    class WakeupWorker : public IScheduledWorker
+    {
+    public:
+        WakeupWorker() : notifiedAt(0), runs(0)
+        {
+        }
+
+        void RunOnce() override
+        {
+            const Clock::duration sinceNotify(Clock::now().time_since_epoch().count() - notifiedAt.load());
+            latency.Record(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceNotify).count()));
+            runs.fetch_add(1);
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "wakeup";
+        }
+
+        void NotifyDurationTimeout(const bool&) const override
+        {
+        }
+
+        std::atomic<Clock::rep> notifiedAt;
+        std::atomic<int> runs;
+        LatencyHistogram<> latency;
+    };
+
+    // From the notification of a triggered job to the start of its execution.
+    void MeasureWakeupLatency(uint32_t poolSize)
+    {
+        WakeupWorker worker;
+        PooledScheduler scheduler(0, poolSize);
+        PooledScheduler::Trigger trigger = scheduler.AttachTriggered(worker, 0);
+        scheduler.Activate();
+        for (int sample = 0; sample < WAKEUP_SAMPLES; ++sample)
+        {
+            worker.notifiedAt.store(Clock::now().time_since_epoch().count());
+            trigger.Notify();
+            while (worker.runs.load() <= sample)
+            {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        scheduler.Deactivate();
+        Print("wakeup_latency_p50", poolSize, worker.latency.GetValueAtPercentile(50.0) / 1000.0, "us");
+        Print("wakeup_latency_p99", poolSize, worker.latency.GetValueAtPercentile(99.0) / 1000.0, "us");
+        Print("wakeup_latency_max", poolSize, worker.latency.GetMaxValue() / 1000.0, "us");
+    }
+
+    std::string JobsSuffix(std::size_t jobCount)
+    {
+        return "_jobs" + std::to_string(jobCount);
+    }
+
+    // The short jobs loading the scheduler besides the measured one, with intervals of 10 to 16 ms.
+    std::vector<std::string> BackgroundNames(std::size_t count)
+    {
+        std::vector<std::string> names;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            names.push_back("job" + std::to_string(index));
+        }
+        return names;
+    }
+
+    Millisecond BackgroundInterval(std::size_t index)
+    {
+        return static_cast<Millisecond>(10 + index % 7);
+    }
+
+    template <typename Histogram>
+    void PrintIntervals(uint32_t poolSize, std::size_t jobCount, const Histogram& interval)
+    {
+        const std::string suffix = JobsSuffix(jobCount);
+        Print(("interval_p50" + suffix).c_str(), poolSize, static_cast<double>(interval.GetValueAtPercentile(50.0)),
+              "us");
+        Print(("interval_p99" + suffix).c_str(), poolSize, static_cast<double>(interval.GetValueAtPercentile(99.0)),
+              "us");
+        Print(("interval_p99.9" + suffix).c_str(), poolSize,
+              static_cast<double>(interval.GetValueAtPercentile(99.9)), "us");
+        Print(("interval_max" + suffix).c_str(), poolSize, static_cast<double>(interval.GetMaxValue()), "us");
+    }
+
+    // The intervals between the executions of a 1 ms job among jobCount jobs in total.
+    void MeasureIntervalJitter(uint32_t poolSize, std::size_t jobCount)
+    {
+        PooledScheduler scheduler(0, poolSize);
+        const std::vector<std::string> names = BackgroundNames(jobCount - 1);
+        std::vector<JobSpec> specs;
+        for (std::size_t index = 0; index < names.size(); ++index)
+        {
+            specs.emplace_back(names[index].c_str(), []() {}, BackgroundInterval(index), 0);
+        }
+        specs.emplace_back("jitter", []() {}, 1, 0);
+        specs.back().latencyHistograms = true;
+        scheduler.AttachBatch(std::move(specs));
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        RoutineLatencyHistogram duration;
+        RoutineLatencyHistogram interval;
+        scheduler.GetLatencyHistograms("jitter", duration, interval);
+        scheduler.Deactivate();
+        PrintIntervals(poolSize, jobCount, interval);
+    }
+
+    // Records the time between the starts of its executions in microseconds, for Scheduler, which
+    // keeps no histograms of its own.
+    class IntervalWorker : public IScheduledWorker
+    {
+    public:
+        IntervalWorker() : last(0)
+        {
+        }
+
+        void RunOnce() override
+        {
+            const Clock::rep now = Clock::now().time_since_epoch().count();
+            if (last != 0)
+            {
+                intervals.Record(static_cast<uint64_t>(Microseconds(Clock::duration(now - last))));
+            }
+            last = now;
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "jitter";
+        }
+
+        void NotifyDurationTimeout(const bool&) const override
+        {
+        }
+
+        Clock::rep last;
+        LatencyHistogram<> intervals;
+    };
+
+    // The same as MeasureIntervalJitter() for a CyclicalWorker of Scheduler.
+    void MeasureSchedulerIntervalJitter(std::size_t jobCount)
+    {
+        IntervalWorker worker;
+        {
+            Scheduler scheduler(0);
+            const std::vector<std::string> names = BackgroundNames(jobCount - 1);
+            for (std::size_t index = 0; index < names.size(); ++index)
+            {
+                scheduler.Attach(names[index].c_str(), []() {}, BackgroundInterval(index), 0);
+            }
+            scheduler.Attach(worker, 1, 0);
+            scheduler.Activate();
+            std::this_thread::sleep_for(std::chrono::seconds(2));
+            scheduler.Deactivate();
+        }
+        PrintIntervals(0, jobCount, worker.intervals);
+    }
+
+    // Submit() calls from a pool thread until the last action has run.
+    void MeasureSubmitThroughput(uint32_t poolSize)
+    {
+        std::atomic<int> done(0);
+        PooledScheduler scheduler(0, poolSize);
+        scheduler.Activate();
+        const Clock::time_point begin = Clock::now();
+        scheduler.Submit([&scheduler, &done]() {
+            for (int index = 0; index < SUBMIT_COUNT; ++index)
+            {
+                scheduler.Submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+        while (done.load() < SUBMIT_COUNT)
+        {
+            std::this_thread::yield();
+        }
+        const double elapsed = Microseconds(Clock::now() - begin);
+        scheduler.Deactivate();
+        Print("submit_throughput", poolSize, SUBMIT_COUNT / elapsed, "actions/us");
+    }
+
+    // AttachBatch() and Detach() of an active scheduler, per job.
+    void MeasureAttachDetach(uint32_t poolSize)
+    {
+        for (const std::size_t batch : ATTACH_BATCHES)
+        {
+            PooledScheduler scheduler(0, poolSize);
+            scheduler.Activate();
+            std::vector<std::string> names;
+            std::vector<JobSpec> specs;
+            for (std::size_t index = 0; index < batch; ++index)
+            {
+                names.push_back("job" + std::to_string(index));
+                specs.emplace_back(names.back().c_str(), []() {}, 100, 0);
+            }
+
+            Clock::time_point begin = Clock::now();
+            scheduler.AttachBatch(std::move(specs));
+            const double attach = Microseconds(Clock::now() - begin) / batch;
+
+            begin = Clock::now();
+            for (const std::string& name : names)
+            {
+                scheduler.Detach(name.c_str());
+            }
+            const double detach = Microseconds(Clock::now() - begin) / batch;
+            scheduler.Deactivate();
+
+            const std::string suffix = "_batch" + std::to_string(batch);
+            Print(("attach_per_job" + suffix).c_str(), poolSize, attach, "us");
+            Print(("detach_per_job" + suffix).c_str(), poolSize, detach, "us");
+        }
+    }
+    // The processor time the whole process spends per execution of an active scheduler's jobs.
+    template <typename AnyScheduler>
+    void PrintDispatchCost(AnyScheduler& scheduler, const std::atomic<long>& runs, uint32_t poolSize,
+                           std::size_t jobCount)
+    {
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        const long runsBefore = runs.load();
+        const double cpuBefore = ProcessCpuMicroseconds();
+        std::this_thread::sleep_for(std::chrono::seconds(3));
+        const long runsAfter = runs.load();
+        const double cpuAfter = ProcessCpuMicroseconds();
+        scheduler.Deactivate();
+        Print(("dispatch_cpu_per_run" + JobsSuffix(jobCount)).c_str(), poolSize,
+              (cpuAfter - cpuBefore) / (runsAfter - runsBefore), "us");
+    }
+
+    // The processor time per execution of jobCount short jobs.
+    void MeasureDispatchCost(uint32_t poolSize, std::size_t jobCount)
+    {
+        std::atomic<long> runs(0);
+        PooledScheduler scheduler(0, poolSize);
+        const std::vector<std::string> names = BackgroundNames(jobCount);
+        std::vector<JobSpec> specs;
+        for (std::size_t index = 0; index < names.size(); ++index)
+        {
+            specs.emplace_back(names[index].c_str(), [&runs]() { runs.fetch_add(1, std::memory_order_relaxed); },
+                               BackgroundInterval(index), 0);
+        }
+        scheduler.AttachBatch(std::move(specs));
+        PrintDispatchCost(scheduler, runs, poolSize, jobCount);
+    }
+
+    // The same as MeasureDispatchCost() for the CyclicalWorkers of Scheduler.
+    void MeasureSchedulerDispatchCost(std::size_t jobCount)
+    {
+        std::atomic<long> runs(0);
+        Scheduler scheduler(0);
+        const std::vector<std::string> names = BackgroundNames(jobCount);
+        for (std::size_t index = 0; index < names.size(); ++index)
+        {
+            scheduler.Attach(names[index].c_str(), [&runs]() { runs.fetch_add(1, std::memory_order_relaxed); },
+                             BackgroundInterval(index), 0);
+        }
+        PrintDispatchCost(scheduler, runs, 0, jobCount);
+    }
+} // namespace
+
+int main()
+{
+    const uint32_t hardwareThreads = std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency();
+    std::printf("metric,pool_threads,value,unit\n");
+    for (const std::size_t jobCount : JOB_COUNTS)
+    {
+        if (jobCount <= SCHEDULER_MAX_JOBS)
+        {
+            MeasureSchedulerIntervalJitter(jobCount);
+            MeasureSchedulerDispatchCost(jobCount);
+        }
+    }
+    for (uint32_t poolSize = 1;; poolSize *= 2)
+    {
+        if (poolSize > hardwareThreads)
+        {
+            poolSize = hardwareThreads;
+        }
+        MeasureWakeupLatency(poolSize);
+        for (const std::size_t jobCount : JOB_COUNTS)
+        {
+            MeasureIntervalJitter(poolSize, jobCount);
+        }
+        MeasureSubmitThroughput(poolSize);
+        MeasureAttachDetach(poolSize);
+        for (const std::size_t jobCount : JOB_COUNTS)
+        {
+            MeasureDispatchCost(poolSize, jobCount);
+        }
+        if (poolSize == hardwareThreads)
+        {
+            break;
+        }
+    }
+    return 0;
+}
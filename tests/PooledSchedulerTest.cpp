@@ -0,0 +1,479 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/PooledScheduler.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    void TestPeriodicJobRuns()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("periodic", [&runs]() { runs.fetch_add(1); }, 5, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 5; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+    }
+
+    class CountingWorker : public IScheduledWorker
+    {
+    public:
+        CountingWorker() : runs(0)
+        {
+        }
+
+        void RunOnce() override
+        {
+            runs.fetch_add(1);
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "counting";
+        }
+
+        void NotifyDurationTimeout(const bool&) const override
+        {
+        }
+
+        std::atomic<int> runs;
+    };
+
+    void TestZeroIntervalRunsBackToBack()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("continuous", [&runs]() { runs.fetch_add(1); }, 0, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 100; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+    }
+
+    void TestTriggeredJobRunsOnlyWhenNotified()
+    {
+        CountingWorker worker;
+        PooledScheduler scheduler(0, 2);
+        PooledScheduler::Trigger trigger = scheduler.AttachTriggered(worker, 0);
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CONCURRENCY_CHECK(worker.runs.load() == 0);
+        CONCURRENCY_CHECK(trigger.Notify());
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.runs.load() == 1; }, std::chrono::seconds(5)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CONCURRENCY_CHECK(worker.runs.load() == 1);
+        scheduler.Deactivate();
+    }
+
+    void TestJobNeverOverlapsItself()
+    {
+        std::atomic<int> inside(0);
+        std::atomic<int> overlaps(0);
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 4);
+        // Executions take longer than the interval, so the job is due again while it runs.
+        scheduler.Attach("slow", [&]() {
+            if (inside.fetch_add(1) != 0)
+            {
+                overlaps.fetch_add(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            inside.fetch_sub(1);
+            runs.fetch_add(1);
+        }, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 10; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(overlaps.load() == 0);
+    }
+
+    void TestDetachStopsExecutions()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("detached", [&runs]() { runs.fetch_add(1); }, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 3; }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(scheduler.Detach("detached"));
+        const int detachedAt = runs.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CONCURRENCY_CHECK(runs.load() == detachedAt);
+        CONCURRENCY_CHECK(!scheduler.Detach("detached"));
+        scheduler.Deactivate();
+    }
+
+    void TestDetachFromPoolThreadDoesNotWaitForQueuedJob()
+    {
+        std::atomic<int> runsB(0);
+        std::atomic<bool> detached(false);
+        std::atomic<int> runsBAfterDetach(-1);
+        PooledScheduler scheduler(0, 1);
+        scheduler.Attach("b", [&runsB]() { runsB.fetch_add(1); }, 1, 0);
+        // "a" holds the only pool thread while "b" is dispatched and queued behind it.
+        scheduler.Attach("a", [&]() {
+            if (detached.load())
+            {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+            scheduler.Detach("b");
+            runsBAfterDetach.store(runsB.load());
+            detached.store(true);
+        }, 10, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&detached]() { return detached.load(); }, std::chrono::seconds(5)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        scheduler.Deactivate();
+        // The queued execution of "b" was discarded rather than started after Detach returned.
+        CONCURRENCY_CHECK(runsB.load() == runsBAfterDetach.load());
+    }
+
+    void TestDetachWaitsForRunningExecution()
+    {
+        std::atomic<bool> running(false);
+        std::atomic<bool> finished(false);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("long", [&]() {
+            running.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            finished.store(true);
+        }, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&running]() { return running.load(); }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(scheduler.Detach("long"));
+        CONCURRENCY_CHECK(finished.load());
+        scheduler.Deactivate();
+    }
+
+    void TestPlacementDuringDeactivate()
+    {
+        CountingWorker placed;
+        std::atomic<bool> deactivating(false);
+        std::atomic<bool> attached(false);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("placing", [&]() {
+            if (attached.load() || !WaitFor([&deactivating]() { return deactivating.load(); }, std::chrono::seconds(5)))
+            {
+                return;
+            }
+            // Deactivate() is now waiting for this execution to complete.
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            scheduler.Attach(placed, 10, 0, ThreadPlacement::OnProcessors({0}));
+            attached.store(true);
+        }, 1, 0);
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        deactivating.store(true);
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(attached.load());
+    }
+
+    void TestWakeRunsJobBeforeItsDeadline()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("slow", [&runs]() { runs.fetch_add(1); }, 60000, 0);
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const int before = runs.load();
+        CONCURRENCY_CHECK(scheduler.Wake("slow"));
+        CONCURRENCY_CHECK(WaitFor([&]() { return runs.load() == before + 1; }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(!scheduler.Wake("unknown"));
+        scheduler.Deactivate();
+    }
+
+    // Repeated wakes move the one deadline entry of the job, and detaching releases the job at
+    // once instead of when the deadline it had before the wakes comes up.
+    void TestDetachReleasesWokenJob()
+    {
+        std::atomic<int> runs(0);
+        std::shared_ptr<int> token = std::make_shared<int>(0);
+        const std::weak_ptr<int> released = token;
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("hourly", [&runs, token]() { runs.fetch_add(1); }, 3600000, 0);
+        token.reset();
+        scheduler.Activate();
+        for (int wake = 1; wake <= 20; ++wake)
+        {
+            CONCURRENCY_CHECK(scheduler.Wake("hourly"));
+            CONCURRENCY_CHECK(WaitFor([&]() { return runs.load() >= wake; }, std::chrono::seconds(5)));
+        }
+        CONCURRENCY_CHECK(scheduler.Detach("hourly"));
+        CONCURRENCY_CHECK(WaitFor([&released]() { return released.expired(); }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+    }
+
+    // A wake arriving while an execution overruns its interval runs the job right after it, also
+    // for a job that skips its missed slots.
+    void TestWakeDuringOverrunIsKept()
+    {
+        typedef std::chrono::steady_clock Clock;
+        std::mutex mutex;
+        std::vector<Clock::time_point> starts;
+        Clock::time_point stallEnd;
+        std::atomic<bool> stalling(false);
+        PooledScheduler scheduler(0, 2);
+        JobSpec spec("overrunning", [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            starts.push_back(Clock::now());
+            if (starts.size() == 2)
+            {
+                lock.unlock();
+                stalling.store(true);
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                lock.lock();
+                stallEnd = Clock::now();
+            }
+        }, 20, 0);
+        spec.catchUp = CatchUpPolicy::SkipToNext;
+        scheduler.AttachBatch(&spec, 1);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&stalling]() { return stalling.load(); }, std::chrono::seconds(5)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(35));
+        CONCURRENCY_CHECK(scheduler.Wake("overrunning"));
+        CONCURRENCY_CHECK(WaitFor([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return stallEnd != Clock::time_point() && starts.back() > stallEnd;
+        }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        // The next slot is 10 ms after the end of the stall.
+        std::lock_guard<std::mutex> lock(mutex);
+        CONCURRENCY_CHECK(starts[2] - stallEnd < std::chrono::milliseconds(5));
+    }
+
+    // Deactivate() from a job would join the calling pool thread: it is ignored and the scheduler
+    // keeps running until it is deactivated from outside.
+    void TestDeactivateFromJobIsIgnored()
+    {
+        std::atomic<int> runs(0);
+        std::atomic<bool> returned(false);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach("deactivating", [&]() {
+            if (runs.fetch_add(1) == 0)
+            {
+                scheduler.Deactivate();
+                returned.store(true);
+            }
+        }, 1, 0);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&returned]() { return returned.load(); }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() >= 5; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        const int stopped = runs.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CONCURRENCY_CHECK(runs.load() == stopped);
+    }
+
+    void TestSubmitRunsOnce()
+    {
+        std::atomic<int> runs(0);
+        PooledScheduler scheduler(0, 2);
+        scheduler.Activate();
+        scheduler.Submit([&runs]() { runs.fetch_add(1); });
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() == 1; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(runs.load() == 1);
+    }
+
+    struct SaturatedRuns
+    {
+        int urgentRuns;
+        uint64_t heavyFaults;
+    };
+
+    // Saturates a single pool thread with three 10 ms jobs sleeping 4 ms each, next to an urgent
+    // fixed-rate 5 ms job of a higher priority, and counts the urgent runs over 500 ms, 100 slots.
+    SaturatedRuns RunSaturated(DispatchPolicy policy, OverloadPolicy overload)
+    {
+        std::atomic<int> urgentRuns(0);
+        PooledScheduler scheduler(0, 1);
+        std::vector<JobSpec> specs;
+        specs.emplace_back("urgent", [&urgentRuns]() { urgentRuns.fetch_add(1); }, 5, 2);
+        specs.back().timing = TimingMode::FixedRate;
+        for (const char* name : {"heavy0", "heavy1", "heavy2"})
+        {
+            specs.emplace_back(name, []() { std::this_thread::sleep_for(std::chrono::milliseconds(4)); }, 10, 0);
+        }
+        scheduler.AttachBatch(std::move(specs));
+        scheduler.SetDispatchPolicy(policy, overload, 1);
+        scheduler.Activate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const int before = urgentRuns.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        SaturatedRuns runs{urgentRuns.load() - before, 0};
+        scheduler.CollectStats([&runs](const JobStats& stats) {
+            if (std::string(stats.name) != "urgent")
+            {
+                runs.heavyFaults += stats.timing.intervalFaultCount;
+            }
+        });
+        scheduler.Deactivate();
+        return runs;
+    }
+
+    // With a rationing policy the urgent job keeps its rate, where it falls to about half when it
+    // queues behind the heavy jobs with DispatchPolicy::Immediate, and late heavy executions dropped
+    // by the overload policy are counted as interval faults.
+    void TestDispatchPolicyUnderOverload()
+    {
+        const SaturatedRuns rateMonotonic = RunSaturated(DispatchPolicy::RateMonotonic, OverloadPolicy::SkipLate);
+        CONCURRENCY_CHECK(rateMonotonic.urgentRuns >= 70);
+        CONCURRENCY_CHECK(rateMonotonic.heavyFaults > 0);
+
+        const SaturatedRuns shed =
+            RunSaturated(DispatchPolicy::EarliestDeadlineFirst, OverloadPolicy::ShedLowPriority);
+        CONCURRENCY_CHECK(shed.urgentRuns >= 70);
+        CONCURRENCY_CHECK(shed.heavyFaults > 0);
+    }
+
+    struct CatchUpRuns
+    {
+        int afterStall;
+        uint64_t faults;
+    };
+
+    // Runs a 20 ms job whose third execution stalls for 105 ms, five intervals and a quarter, and
+    // counts the executions starting from the end of the stall until 8 ms before the next regular
+    // slot, which is due 120 ms after the stalled execution started at the latest.
+    CatchUpRuns RunAfterStall(CatchUpPolicy catchUp)
+    {
+        typedef std::chrono::steady_clock Clock;
+        std::mutex mutex;
+        std::vector<Clock::time_point> starts;
+        Clock::time_point stallEnd;
+        PooledScheduler scheduler(0, 2);
+        JobSpec spec("stalling", [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            starts.push_back(Clock::now());
+            if (starts.size() == 3)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(105));
+                stallEnd = Clock::now();
+            }
+        }, 20, 0);
+        spec.catchUp = catchUp;
+        scheduler.AttachBatch(&spec, 1);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return stallEnd != Clock::time_point() && Clock::now() - stallEnd > std::chrono::milliseconds(50);
+        }, std::chrono::seconds(5)));
+        CatchUpRuns runs{0, 0};
+        scheduler.CollectStats([&runs](const JobStats& stats) { runs.faults = stats.timing.intervalFaultCount; });
+        scheduler.Deactivate();
+        const Clock::time_point nextSlot = starts[2] + std::chrono::milliseconds(120);
+        for (const Clock::time_point& start : starts)
+        {
+            runs.afterStall += start >= stallEnd && start < nextSlot - std::chrono::milliseconds(8);
+        }
+        return runs;
+    }
+
+    // After a stall of five intervals FireAll runs every missed slot back to back, FireOnce runs
+    // once, and SkipToNext waits for the next slot and counts the missed ones as an interval fault.
+    void TestCatchUpPolicies()
+    {
+        const CatchUpRuns fireAll = RunAfterStall(CatchUpPolicy::FireAll);
+        CONCURRENCY_CHECK(fireAll.afterStall >= 4 && fireAll.afterStall <= 5);
+
+        const CatchUpRuns fireOnce = RunAfterStall(CatchUpPolicy::FireOnce);
+        CONCURRENCY_CHECK(fireOnce.afterStall == 1);
+
+        const CatchUpRuns skipToNext = RunAfterStall(CatchUpPolicy::SkipToNext);
+        CONCURRENCY_CHECK(skipToNext.afterStall == 0);
+        CONCURRENCY_CHECK(skipToNext.faults >= 1);
+    }
+
+    // Records the start of every execution.
+    class TimestampWorker : public IScheduledWorker
+    {
+    public:
+        void RunOnce() override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            starts.push_back(std::chrono::steady_clock::now());
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "timestamp";
+        }
+
+        void NotifyDurationTimeout(const bool&) const override
+        {
+        }
+
+        std::mutex mutex;
+        std::vector<std::chrono::steady_clock::time_point> starts;
+    };
+
+    // Counts the executions of a fixed-rate job over 200 intervals, from its tenth execution on.
+    int RunFixedRate(std::chrono::microseconds interval, const DispatchTiming& timing)
+    {
+        const int intervals = 200;
+        TimestampWorker worker;
+        PooledScheduler scheduler(0, 2);
+        scheduler.SetDispatchTiming(timing);
+        scheduler.Attach(worker, interval, 0, TimingMode::FixedRate, CatchUpPolicy::FireAll);
+        scheduler.Activate();
+        const auto enough = [&worker, interval]() {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            return worker.starts.size() >= 10 &&
+                   std::chrono::steady_clock::now() - worker.starts[9] > interval * (intervals + 1);
+        };
+        CONCURRENCY_CHECK(WaitFor(enough, std::chrono::seconds(10)));
+        scheduler.Deactivate();
+        const auto end = worker.starts[9] + interval * intervals - interval / 2;
+        int runs = 0;
+        for (std::size_t index = 9; index < worker.starts.size() && worker.starts[index] < end; ++index)
+        {
+            ++runs;
+        }
+        return runs;
+    }
+
+    // Late wakeups of the dispatch thread do not shift the slots of a fixed-rate job, so it runs
+    // once per interval without drifting, on the condition variable at 2 ms and on the precise
+    // timer with a spin phase at 500 us. FireAll makes up for a slot missed to preemption.
+    void TestFixedRateDoesNotDrift()
+    {
+        const int runs = RunFixedRate(std::chrono::microseconds(2000), DispatchTiming());
+        CONCURRENCY_CHECK(runs >= 199 && runs <= 201);
+
+        DispatchTiming precise;
+        precise.preciseWindow = 1000;
+        precise.spinPhase = 100;
+        const int preciseRuns = RunFixedRate(std::chrono::microseconds(500), precise);
+        CONCURRENCY_CHECK(preciseRuns >= 199 && preciseRuns <= 201);
+    }
+} // namespace
+
+int main()
+{
+    TestPeriodicJobRuns();
+    TestZeroIntervalRunsBackToBack();
+    TestTriggeredJobRunsOnlyWhenNotified();
+    TestJobNeverOverlapsItself();
+    TestDetachStopsExecutions();
+    TestDetachFromPoolThreadDoesNotWaitForQueuedJob();
+    TestDetachWaitsForRunningExecution();
+    TestPlacementDuringDeactivate();
+    TestWakeRunsJobBeforeItsDeadline();
+    TestDetachReleasesWokenJob();
+    TestWakeDuringOverrunIsKept();
+    TestDeactivateFromJobIsIgnored();
+    TestSubmitRunsOnce();
+    TestDispatchPolicyUnderOverload();
+    TestCatchUpPolicies();
+    TestFixedRateDoesNotDrift();
+    return ConcurrencyTest::Result();
+}
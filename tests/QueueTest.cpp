@@ -0,0 +1,156 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/MpmcQueue.hpp>
+#include <Concurrency/SpscQueue.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    template <typename Queue>
+    void CheckBoundedFifo()
+    {
+        Queue queue(4);
+        for (uint64_t value = 1; value <= 4; ++value)
+        {
+            CONCURRENCY_CHECK(queue.TryPush(value));
+        }
+        CONCURRENCY_CHECK(!queue.TryPush(5));
+        uint64_t item = 0;
+        for (uint64_t value = 1; value <= 4; ++value)
+        {
+            CONCURRENCY_CHECK(queue.TryPop(item) && item == value);
+        }
+        CONCURRENCY_CHECK(!queue.TryPop(item));
+    }
+
+    void TestBoundedFifo()
+    {
+        CheckBoundedFifo<SpscQueue<uint64_t>>();
+        CheckBoundedFifo<MpmcQueue<uint64_t>>();
+    }
+
+    // The consumer must receive every item in order, through batches smaller than the ring.
+    void TestSpscKeepsOrderAcrossThreads()
+    {
+        const uint64_t count = 200000;
+        SpscQueue<uint64_t> queue(64);
+        std::thread producer([&queue, count]() {
+            uint64_t next = 1;
+            while (next <= count)
+            {
+                uint64_t batch[8];
+                std::size_t size = 0;
+                for (; size < 8 && next + size <= count; ++size)
+                {
+                    batch[size] = next + size;
+                }
+                const std::size_t pushed = queue.PushBatch(batch, size);
+                next += pushed;
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint64_t expected = 1;
+        bool ordered = true;
+        while (expected <= count)
+        {
+            uint64_t batch[5];
+            const std::size_t popped = queue.PopBatch(batch, 5);
+            for (std::size_t index = 0; index < popped; ++index)
+            {
+                ordered = ordered && batch[index] == expected;
+                ++expected;
+            }
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        CONCURRENCY_CHECK(ordered);
+    }
+
+    // Every item pushed by the producers must be popped exactly once by the consumers.
+    void TestMpmcDeliversEveryItemOnce()
+    {
+        const uint64_t perProducer = 50000;
+        const int producerCount = 3;
+        const int consumerCount = 3;
+        const uint64_t count = perProducer * producerCount;
+        MpmcQueue<uint64_t> queue(128);
+        std::vector<std::atomic<int>> seen(count);
+        std::atomic<uint64_t> popped(0);
+
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < producerCount; ++producer)
+        {
+            threads.emplace_back([&queue, producer, perProducer]() {
+                uint64_t next = 0;
+                while (next < perProducer)
+                {
+                    uint64_t batch[4];
+                    std::size_t size = 0;
+                    for (; size < 4 && next + size < perProducer; ++size)
+                    {
+                        batch[size] = producer * perProducer + next + size;
+                    }
+                    const std::size_t pushed = queue.PushBatch(batch, size);
+                    next += pushed;
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int consumer = 0; consumer < consumerCount; ++consumer)
+        {
+            threads.emplace_back([&queue, &seen, &popped, count]() {
+                while (popped.load() < count)
+                {
+                    uint64_t batch[5];
+                    const std::size_t size = queue.PopBatch(batch, 5);
+                    for (std::size_t index = 0; index < size; ++index)
+                    {
+                        seen[batch[index]].fetch_add(1);
+                    }
+                    popped.fetch_add(size);
+                    if (size == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        int wrong = 0;
+        for (const std::atomic<int>& times : seen)
+        {
+            wrong += times.load() != 1;
+        }
+        CONCURRENCY_CHECK(popped.load() == count);
+        CONCURRENCY_CHECK(wrong == 0);
+    }
+} // namespace
+
+int main()
+{
+    TestBoundedFifo();
+    TestSpscKeepsOrderAcrossThreads();
+    TestMpmcDeliversEveryItemOnce();
+    return ConcurrencyTest::Result();
+}
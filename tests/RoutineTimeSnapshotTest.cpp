@@ -0,0 +1,138 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/RoutineTimeSnapshot.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    // Expectations far above the executions, so the monitor itself never counts a fault.
+    const Microsecond EXPECTED_DURATION = 10000000;
+    const Microsecond EXPECTED_INTERVAL = 10000000;
+
+    void TestSnapshotReflectsStop()
+    {
+        PublishedRoutineTimeMonitor monitor(EXPECTED_DURATION, EXPECTED_INTERVAL);
+        CONCURRENCY_CHECK(monitor.Snapshot().sampleCount == 0);
+        monitor.Start();
+        monitor.Stop();
+        monitor.Start();
+        monitor.Stop();
+        const RoutineTimeSnapshot snapshot = monitor.Snapshot();
+        CONCURRENCY_CHECK(snapshot.sampleCount == 2);
+        CONCURRENCY_CHECK(snapshot.minDuration <= snapshot.maxDuration);
+    }
+
+    // The writer publishes twice per cycle, after Stop() and after counting an interval fault,
+    // so a consistent snapshot has as many new faults as new samples or one fewer. A snapshot
+    // mixing the fields of two publications breaks that, or makes the counts go backwards.
+    void TestConcurrentSnapshotsAreConsistent()
+    {
+        const uint64_t cycles = 2000000;
+        const int readerCount = 3;
+        PublishedRoutineTimeMonitor monitor(EXPECTED_DURATION, EXPECTED_INTERVAL);
+        // The first cycles give the monitor an interval; faults it counts there are the baseline.
+        monitor.Start();
+        monitor.Stop();
+        monitor.Start();
+        monitor.Stop();
+        const RoutineTimeSnapshot baseline = monitor.Snapshot();
+        std::atomic<bool> writing(true);
+        std::atomic<int> torn(0);
+        std::atomic<int> backwards(0);
+
+        std::vector<std::thread> readers;
+        for (int reader = 0; reader < readerCount; ++reader)
+        {
+            readers.emplace_back([&]() {
+                uint64_t lastSamples = 0;
+                while (writing.load())
+                {
+                    const RoutineTimeSnapshot snapshot = monitor.Snapshot();
+                    const uint64_t samples = snapshot.sampleCount - baseline.sampleCount;
+                    const uint64_t faults = snapshot.intervalFaultCount - baseline.intervalFaultCount;
+                    if (faults != samples && faults + 1 != samples)
+                    {
+                        torn.fetch_add(1);
+                    }
+                    if (snapshot.sampleCount < lastSamples)
+                    {
+                        backwards.fetch_add(1);
+                    }
+                    lastSamples = snapshot.sampleCount;
+                }
+            });
+        }
+
+        for (uint64_t cycle = 0; cycle < cycles; ++cycle)
+        {
+            monitor.Start();
+            monitor.Stop();
+            monitor.IncrementIntervalFaultCount();
+        }
+        writing.store(false);
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+
+        const RoutineTimeSnapshot last = monitor.Snapshot();
+        CONCURRENCY_CHECK(last.sampleCount - baseline.sampleCount == cycles);
+        CONCURRENCY_CHECK(last.intervalFaultCount - baseline.intervalFaultCount == cycles);
+        CONCURRENCY_CHECK(torn.load() == 0);
+        CONCURRENCY_CHECK(backwards.load() == 0);
+    }
+
+    // Spins the calling thread for the given time, so it uses about as much processor time.
+    void Spin(std::chrono::milliseconds duration)
+    {
+        const auto until = std::chrono::steady_clock::now() + duration;
+        volatile uint64_t spins = 0;
+        while (std::chrono::steady_clock::now() < until)
+        {
+            spins = spins + 1;
+        }
+    }
+
+    // Busy routines are charged their processor time, which the totals accumulate, and a monitor
+    // without CPU accounting leaves the fields at 0.
+    void TestCpuAccounting()
+    {
+        PublishedRoutineTimeMonitor monitor(EXPECTED_DURATION, EXPECTED_INTERVAL);
+        monitor.EnableCpuAccounting();
+        CONCURRENCY_CHECK(monitor.IsCpuAccounting());
+        for (int routine = 0; routine < 3; ++routine)
+        {
+            monitor.Start();
+            Spin(std::chrono::milliseconds(10 * (routine + 1)));
+            monitor.Stop();
+        }
+        const RoutineTimeSnapshot snapshot = monitor.Snapshot();
+        CONCURRENCY_CHECK(snapshot.currentCpuTime > 0);
+        CONCURRENCY_CHECK(snapshot.maxCpuTime >= snapshot.currentCpuTime);
+        CONCURRENCY_CHECK(snapshot.totalCpuTime >= snapshot.maxCpuTime);
+        CONCURRENCY_CHECK(snapshot.totalCpuTime > snapshot.currentCpuTime);
+
+        PublishedRoutineTimeMonitor unaccounted(EXPECTED_DURATION, EXPECTED_INTERVAL);
+        unaccounted.Start();
+        Spin(std::chrono::milliseconds(5));
+        unaccounted.Stop();
+        const RoutineTimeSnapshot idle = unaccounted.Snapshot();
+        CONCURRENCY_CHECK(!unaccounted.IsCpuAccounting());
+        CONCURRENCY_CHECK(idle.currentCpuTime == 0 && idle.totalCpuTime == 0);
+    }
+} // namespace
+
+int main()
+{
+    TestSnapshotReflectsStop();
+    TestConcurrentSnapshotsAreConsistent();
+    TestCpuAccounting();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <Concurrency/TaskGraph.hpp>
+#include <Concurrency/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    // Runs one execution of the graph on a worker thread of the pool, which the graph enlists.
+    void RunOnPoolThread(ThreadPool& pool, TaskGraph& graph)
+    {
+        std::atomic<bool> done(false);
+        pool.Submit([&graph, &done]() {
+            graph.RunOnce();
+            done.store(true);
+        });
+        CONCURRENCY_CHECK(WaitFor([&done]() { return done.load(); }, std::chrono::seconds(10)));
+    }
+
+    // A graph that ran on a pool keeps its helpers; running it outside of a pool must not hand them out.
+    void TestRunsInlineAfterRunningOnPool()
+    {
+        std::atomic<int> runs(0);
+        ThreadPool pool(4);
+        pool.Start();
+        TaskGraph graph("graph");
+        for (int node = 0; node < 4; ++node)
+        {
+            graph.Add([&runs]() { runs.fetch_add(1); });
+        }
+        RunOnPoolThread(pool, graph);
+        CONCURRENCY_CHECK(runs.load() == 4);
+        graph.RunOnce();
+        CONCURRENCY_CHECK(runs.load() == 8);
+        RunOnPoolThread(pool, graph);
+        CONCURRENCY_CHECK(runs.load() == 12);
+        pool.Stop();
+    }
+
+    // Every branch runs after the source and before the sink, on every execution.
+    void TestFanOutFanInOrder()
+    {
+        const int branches = 8;
+        std::atomic<int> clock(0);
+        int sourceAt = 0;
+        int sinkAt = 0;
+        std::vector<std::atomic<int>> branchAt(branches);
+        ThreadPool pool(4);
+        pool.Start();
+        TaskGraph graph("fan", &pool);
+        const TaskGraph::Node source = graph.Add([&]() { sourceAt = clock.fetch_add(1); });
+        const TaskGraph::Node sink = graph.Add([&]() { sinkAt = clock.fetch_add(1); });
+        for (int branch = 0; branch < branches; ++branch)
+        {
+            const TaskGraph::Node node = graph.Add([&, branch]() { branchAt[branch].store(clock.fetch_add(1)); });
+            CONCURRENCY_CHECK(graph.Precede(source, node));
+            CONCURRENCY_CHECK(graph.Precede(node, sink));
+        }
+        CONCURRENCY_CHECK(!graph.Precede(sink, source));
+        CONCURRENCY_CHECK(graph.GetNodeCount() == branches + 2);
+
+        bool ordered = true;
+        for (int execution = 0; execution < 100; ++execution)
+        {
+            graph.RunOnce();
+            for (const std::atomic<int>& at : branchAt)
+            {
+                ordered = ordered && sourceAt < at.load() && at.load() < sinkAt;
+            }
+            ordered = ordered && sinkAt == clock.load() - 1;
+        }
+        CONCURRENCY_CHECK(ordered);
+        pool.Stop();
+    }
+
+    // The first exception is rethrown after the running actions completed, and the successors are skipped.
+    void TestExceptionIsRethrown()
+    {
+        std::atomic<int> successorRuns(0);
+        std::atomic<bool> fail(true);
+        ThreadPool pool(2);
+        pool.Start();
+        TaskGraph graph("throwing", &pool);
+        const TaskGraph::Node first = graph.Add([&fail]() {
+            if (fail.load())
+            {
+                throw std::runtime_error("first");
+            }
+        });
+        const TaskGraph::Node second = graph.Add([&successorRuns]() { successorRuns.fetch_add(1); });
+        graph.Precede(first, second);
+
+        bool thrown = false;
+        try
+        {
+            graph.RunOnce();
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CONCURRENCY_CHECK(thrown);
+        CONCURRENCY_CHECK(successorRuns.load() == 0);
+
+        fail.store(false);
+        graph.RunOnce();
+        CONCURRENCY_CHECK(successorRuns.load() == 1);
+        pool.Stop();
+    }
+} // namespace
+
+int main()
+{
+    TestRunsInlineAfterRunningOnPool();
+    TestFanOutFanInOrder();
+    TestExceptionIsRethrown();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,140 @@
+#include <atomic>
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/Task.hpp>
+
+#include "TestCheck.hpp"
+
+#if !CONCURRENCY_HAS_COROUTINES
+#error "TaskTest needs a compiler with C++20 coroutines"
+#endif
+
+using namespace Concurrency;
+
+namespace
+{
+    // Resumes the awaiting coroutine on a thread of its own, like an I/O completion would.
+    struct ResumeOnNewThread
+    {
+        std::thread* thread;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            *thread = std::thread([handle]() { handle.resume(); });
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    Task<int> Answer()
+    {
+        co_return 42;
+    }
+
+    Task<std::string> Fail()
+    {
+        throw std::runtime_error("task");
+        co_return std::string();
+    }
+
+    Task<int> AddAnswers(std::vector<int>& order)
+    {
+        order.push_back(1);
+        const int first = co_await Answer();
+        order.push_back(2);
+        const int second = co_await Answer();
+        order.push_back(3);
+        co_return first + second;
+    }
+
+    Task<std::thread::id> SwitchThread(std::thread& thread)
+    {
+        co_await ResumeOnNewThread{&thread};
+        co_return std::this_thread::get_id();
+    }
+
+    Task<void> CatchFailure(bool& caught)
+    {
+        try
+        {
+            co_await Fail();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+    }
+
+    void TestSyncWaitValue()
+    {
+        CONCURRENCY_CHECK(SyncWait(Answer()) == 42);
+        std::vector<int> order;
+        CONCURRENCY_CHECK(SyncWait(AddAnswers(order)) == 84);
+        CONCURRENCY_CHECK(order == std::vector<int>({1, 2, 3}));
+    }
+
+    void TestSyncWaitException()
+    {
+        bool thrown = false;
+        try
+        {
+            SyncWait(Fail());
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CONCURRENCY_CHECK(thrown);
+
+        bool caught = false;
+        SyncWait(CatchFailure(caught));
+        CONCURRENCY_CHECK(caught);
+    }
+
+    // A task is lazy, and a task resumed on another thread completes there while SyncWait blocks.
+    void TestContinuationOnAnotherThread()
+    {
+        Task<int> lazy = Answer();
+        CONCURRENCY_CHECK(static_cast<bool>(lazy) && !lazy.IsDone());
+        CONCURRENCY_CHECK(SyncWait(std::move(lazy)) == 42);
+
+        std::thread thread;
+        const std::thread::id resumedOn = SyncWait(SwitchThread(thread));
+        const std::thread::id completer = thread.get_id();
+        thread.join();
+        CONCURRENCY_CHECK(resumedOn == completer && resumedOn != std::this_thread::get_id());
+    }
+
+    // Start() calls the completion once the coroutine has completed, and the result is kept until read.
+    void TestStartWithCompletion()
+    {
+        std::atomic<int> completions(0);
+        Task<int> task = Answer();
+        task.Start([](void* context) { static_cast<std::atomic<int>*>(context)->fetch_add(1); }, &completions);
+        CONCURRENCY_CHECK(completions.load() == 1 && task.IsDone());
+        CONCURRENCY_CHECK(task.GetResult() == 42);
+
+        Task<int> moved = std::move(task);
+        CONCURRENCY_CHECK(!task && moved.IsDone());
+    }
+} // namespace
+
+int main()
+{
+    TestSyncWaitValue();
+    TestSyncWaitException();
+    TestContinuationOnAnotherThread();
+    TestStartWithCompletion();
+    return ConcurrencyTest::Result();
+}
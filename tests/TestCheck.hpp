@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace ConcurrencyTest
+{
+    /**
+     * @brief Gets the number of failed checks of the test program.
+     */
+    inline int& FailureCount()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    /**
+     * @brief Records the outcome of one check, printing the failed ones.
+     */
+    inline void Check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            ++FailureCount();
+        }
+    }
+
+    /**
+     * @brief Polls a condition until it holds or a timeout has passed.
+     *
+     * @return true if the condition held in time.
+     */
+    template <typename Condition>
+    bool WaitFor(Condition condition, std::chrono::milliseconds timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief The exit code of the test program.
+     */
+    inline int Result()
+    {
+        if (FailureCount() != 0)
+        {
+            std::fprintf(stderr, "%d checks failed\n", FailureCount());
+            return 1;
+        }
+        return 0;
+    }
+} // namespace ConcurrencyTest
+
+#define CONCURRENCY_CHECK(condition) ConcurrencyTest::Check((condition), #condition, __FILE__, __LINE__)
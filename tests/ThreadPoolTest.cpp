@@ -0,0 +1,119 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <Concurrency/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    class RepeatingTask : public ITask
+    {
+    public:
+        explicit RepeatingTask(int times) : times(times), runs(0)
+        {
+        }
+
+        bool Run() override
+        {
+            return runs.fetch_add(1) + 1 < times;
+        }
+
+        const int times;
+        std::atomic<int> runs;
+    };
+
+    // Actions submitted from a worker thread go to its own deque and are stolen by the others.
+    void TestNestedSubmitsAllRun()
+    {
+        const int depth = 12;
+        std::atomic<long> runs(0);
+        ThreadPool pool(4);
+        pool.Start();
+        std::function<void(int)> fan = [&](int level) {
+            runs.fetch_add(1);
+            if (level < depth)
+            {
+                pool.Submit([&fan, level]() { fan(level + 1); });
+                pool.Submit([&fan, level]() { fan(level + 1); });
+            }
+        };
+        pool.Submit([&fan]() { fan(0); });
+        const long expected = (1L << (depth + 1)) - 1;
+        CONCURRENCY_CHECK(WaitFor([&]() { return runs.load() == expected; }, std::chrono::seconds(10)));
+        pool.Stop();
+        CONCURRENCY_CHECK(runs.load() == expected);
+    }
+
+    void TestStopRunsPendingActions()
+    {
+        const int count = 100000;
+        std::atomic<int> runs(0);
+        ThreadPool pool(2);
+        pool.Start();
+        for (int index = 0; index < count; ++index)
+        {
+            pool.Submit([&runs]() { runs.fetch_add(1); });
+        }
+        pool.Stop();
+        CONCURRENCY_CHECK(runs.load() == count);
+    }
+
+    void TestTaskIsResubmittedWhileItReturnsTrue()
+    {
+        RepeatingTask task(100);
+        ThreadPool pool(2);
+        pool.Start();
+        pool.Submit(task);
+        CONCURRENCY_CHECK(WaitFor([&task]() { return task.runs.load() == task.times; }, std::chrono::seconds(10)));
+        pool.Stop();
+        CONCURRENCY_CHECK(task.runs.load() == task.times);
+    }
+
+    // Submits bursts of actions with idle gaps between them, so the threads spin, yield and park in
+    // turn, and stops the pool while its threads are idle.
+    void RunIdleBursts(const IdleStrategy& strategy)
+    {
+        const int bursts = 20;
+        const int burst = 50;
+        std::atomic<int> runs(0);
+        ThreadPool pool(2);
+        pool.SetIdleStrategy(strategy);
+        pool.Start();
+        for (int index = 0; index < bursts; ++index)
+        {
+            for (int action = 0; action < burst; ++action)
+            {
+                pool.Submit([&runs]() { runs.fetch_add(1); });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(index % 2 == 0 ? 100 : 3000));
+        }
+        CONCURRENCY_CHECK(WaitFor([&runs]() { return runs.load() == bursts * burst; }, std::chrono::seconds(10)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pool.Stop();
+        CONCURRENCY_CHECK(runs.load() == bursts * burst);
+    }
+
+    // Spinning threads pick up every action and still return from Stop(), and so do backing off
+    // threads whether they are spinning, yielding or parked.
+    void TestIdleStrategies()
+    {
+        RunIdleBursts(IdleStrategy::BusySpinning());
+        RunIdleBursts(IdleStrategy::BackingOff(200, 500));
+        RunIdleBursts(IdleStrategy::BackingOff(0, 0));
+    }
+} // namespace
+
+int main()
+{
+    TestNestedSubmitsAllRun();
+    TestStopRunsPendingActions();
+    TestTaskIsResubmittedWhileItReturnsTrue();
+    TestIdleStrategies();
+    return ConcurrencyTest::Result();
+}
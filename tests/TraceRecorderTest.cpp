@@ -0,0 +1,170 @@
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/TraceRecorder.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    template <typename T>
+    T ReadValue(std::istream& stream)
+    {
+        T value = T();
+        stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    template <typename Record>
+    void OnNewThread(Record record)
+    {
+        std::thread thread(record);
+        thread.join();
+    }
+
+    // Events come back in the order they were recorded, with the fields they were recorded with.
+    void TestRecordCollect()
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        std::vector<TraceEvent> events;
+        recorder.Collect(events);
+        const uint32_t job = recorder.RegisterJob("round trip");
+        recorder.Record(TraceEventType::Run, job, 1500, 2500);
+        recorder.Record(TraceEventType::Missed, job, 4000);
+
+        events.clear();
+        CONCURRENCY_CHECK(recorder.Collect(events) == 2 && events.size() == 2);
+        CONCURRENCY_CHECK(events[0].type == TraceEventType::Run && events[0].jobId == job);
+        CONCURRENCY_CHECK(events[0].timestamp == 1500 && events[0].duration == 2500);
+        CONCURRENCY_CHECK(events[1].type == TraceEventType::Missed && events[1].timestamp == 4000);
+        CONCURRENCY_CHECK(events[1].duration == 0 && events[1].thread == events[0].thread);
+        events.clear();
+        CONCURRENCY_CHECK(recorder.Collect(events) == 0 && events.empty());
+    }
+
+    // Events recorded into a full ring are dropped and counted, and the buffer of a thread that has
+    // exited is released once its events have been collected.
+    void TestFullRingAndExitedThread()
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        std::vector<TraceEvent> events;
+        recorder.Collect(events);
+        const std::size_t buffers = recorder.GetBufferCount();
+        const uint64_t dropped = recorder.GetDroppedCount();
+        const uint32_t job = recorder.RegisterJob("full ring");
+
+        recorder.Enable(3);
+        OnNewThread([&recorder, job]() {
+            for (uint64_t timestamp = 0; timestamp < 6; ++timestamp)
+            {
+                recorder.Record(TraceEventType::Run, job, timestamp, 1);
+            }
+        });
+        recorder.Disable();
+        CONCURRENCY_CHECK(recorder.GetDroppedCount() == dropped + 2);
+        CONCURRENCY_CHECK(recorder.GetBufferCount() == buffers + 1);
+
+        events.clear();
+        CONCURRENCY_CHECK(recorder.Collect(events) == 4);
+        CONCURRENCY_CHECK(events.front().timestamp == 0 && events.back().timestamp == 3);
+        CONCURRENCY_CHECK(recorder.GetBufferCount() == buffers);
+        recorder.Enable();
+        recorder.Disable();
+    }
+
+    void TestWriteBinary()
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        std::vector<TraceEvent> events;
+        recorder.Collect(events);
+        const uint32_t job = recorder.RegisterJob("binary");
+        recorder.Record(TraceEventType::Run, job, 10, 20);
+        recorder.Record(TraceEventType::IntervalFault, job, 30);
+        events.clear();
+        recorder.Collect(events);
+
+        std::stringstream stream;
+        recorder.WriteBinary(stream, events);
+        char magic[4] = {};
+        stream.read(magic, sizeof(magic));
+        CONCURRENCY_CHECK(std::memcmp(magic, "CTRC", 4) == 0);
+        CONCURRENCY_CHECK(ReadValue<uint32_t>(stream) == 1);
+        const uint32_t names = ReadValue<uint32_t>(stream);
+        CONCURRENCY_CHECK(names == job);
+        std::string name;
+        for (uint32_t index = 0; index < names; ++index)
+        {
+            name.resize(ReadValue<uint32_t>(stream));
+            stream.read(&name[0], static_cast<std::streamsize>(name.size()));
+        }
+        CONCURRENCY_CHECK(name == "binary");
+        CONCURRENCY_CHECK(ReadValue<uint64_t>(stream) == 2);
+        for (const TraceEvent& expected : events)
+        {
+            const TraceEvent event = ReadValue<TraceEvent>(stream);
+            CONCURRENCY_CHECK(event.timestamp == expected.timestamp && event.duration == expected.duration &&
+                              event.jobId == expected.jobId && event.type == expected.type &&
+                              event.thread == expected.thread);
+        }
+        CONCURRENCY_CHECK(stream.peek() == std::char_traits<char>::eof());
+    }
+
+    // Runs become complete events with a duration, the others instant events, and job names are
+    // escaped for JSON.
+    void TestWriteChromeTrace()
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        std::vector<TraceEvent> events;
+        recorder.Collect(events);
+        const uint32_t job = recorder.RegisterJob("say \"hi\"\\\n");
+        recorder.Record(TraceEventType::Run, job, 1500, 2005);
+        recorder.Record(TraceEventType::Skipped, job, 7000);
+        recorder.Record(TraceEventType::DurationOverrun, job + 1000, 8000);
+        events.clear();
+        recorder.Collect(events);
+
+        std::ostringstream stream;
+        recorder.WriteChromeTrace(stream, events);
+        const std::string thread = std::to_string(events.front().thread);
+        const std::string expected =
+            "{\"traceEvents\":[\n"
+            "{\"name\":\"say \\\"hi\\\"\\\\\",\"cat\":\"run\",\"pid\":1,\"tid\":" + thread +
+            ",\"ts\":1.500,\"ph\":\"X\",\"dur\":2.005},\n"
+            "{\"name\":\"say \\\"hi\\\"\\\\\",\"cat\":\"skipped\",\"pid\":1,\"tid\":" + thread +
+            ",\"ts\":7.000,\"ph\":\"i\",\"s\":\"t\"},\n"
+            "{\"name\":\"?\",\"cat\":\"overrun\",\"pid\":1,\"tid\":" + thread +
+            ",\"ts\":8.000,\"ph\":\"i\",\"s\":\"t\"}\n"
+            "]}\n";
+        CONCURRENCY_CHECK(stream.str() == expected);
+
+        std::ostringstream empty;
+        recorder.WriteChromeTrace(empty, std::vector<TraceEvent>());
+        CONCURRENCY_CHECK(empty.str() == "{\"traceEvents\":[\n]}\n");
+    }
+
+    // This file is also built as TraceRecorderDisabledTest, with CONCURRENCY_TRACE_ENABLED set to 0.
+    void TestIsEnabled()
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        recorder.Enable();
+        CONCURRENCY_CHECK(TraceRecorder::IsEnabled() == (CONCURRENCY_TRACE_ENABLED != 0));
+        recorder.Disable();
+        CONCURRENCY_CHECK(!TraceRecorder::IsEnabled());
+    }
+} // namespace
+
+int main()
+{
+    TestRecordCollect();
+    TestFullRingAndExitedThread();
+    TestWriteBinary();
+    TestWriteChromeTrace();
+    TestIsEnabled();
+    return ConcurrencyTest::Result();
+}
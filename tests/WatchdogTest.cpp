@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <Concurrency/PooledScheduler.hpp>
+#include <Concurrency/Watchdog.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+using ConcurrencyTest::WaitFor;
+
+namespace
+{
+    // Runs long on its first execution only, and counts the timeout notifications it receives.
+    class StallingWorker : public IScheduledWorker
+    {
+    public:
+        explicit StallingWorker(std::chrono::milliseconds stall) : stall(stall), runs(0), timeouts(0)
+        {
+        }
+
+        void RunOnce() override
+        {
+            if (runs.fetch_add(1) == 0)
+            {
+                std::this_thread::sleep_for(stall);
+            }
+        }
+
+        const char* GetWorkerName() const override
+        {
+            return "stalling";
+        }
+
+        void NotifyDurationTimeout(const bool& isTimeout) const override
+        {
+            if (isTimeout)
+            {
+                timeouts.fetch_add(1);
+            }
+        }
+
+        const std::chrono::milliseconds stall;
+        std::atomic<int> runs;
+        mutable std::atomic<int> timeouts;
+    };
+
+    // The watchdog notifies the stalled worker, and the end of the execution does not notify it again.
+    void TestStallNotifiedOnce()
+    {
+        StallingWorker worker(std::chrono::milliseconds(200));
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach(worker, 0, 10, 20);
+        scheduler.Activate();
+        {
+            Watchdog watchdog(scheduler, 5);
+            CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.timeouts.load() == 1; }, std::chrono::seconds(5)));
+            CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.runs.load() >= 3; }, std::chrono::seconds(5)));
+            CONCURRENCY_CHECK(watchdog.GetStallCount() == 1);
+        }
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(worker.timeouts.load() == 1);
+    }
+
+    // An execution overrunning without a watchdog is still notified when it returns.
+    void TestStallNotifiedOnEndWithoutWatchdog()
+    {
+        StallingWorker worker(std::chrono::milliseconds(50));
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach(worker, 0, 10, 20);
+        scheduler.Activate();
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.runs.load() >= 2; }, std::chrono::seconds(5)));
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(worker.timeouts.load() == 1);
+    }
+
+    // Detaching a job whose stall is being reported waits for the stall callback to return.
+    void TestDetachWaitsForCallback()
+    {
+        std::atomic<bool> inCallback(false);
+        std::atomic<bool> release(false);
+        StallingWorker worker(std::chrono::milliseconds(100));
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach(worker, 0, 10, 20);
+        scheduler.Activate();
+        Watchdog watchdog(
+            scheduler, 5,
+            [&](const RunningJob&) {
+                inCallback.store(true);
+                WaitFor([&release]() { return release.load(); }, std::chrono::seconds(10));
+            },
+            false);
+        CONCURRENCY_CHECK(WaitFor([&inCallback]() { return inCallback.load(); }, std::chrono::seconds(5)));
+        CONCURRENCY_CHECK(WaitFor([&worker]() { return worker.runs.load() >= 1; }, std::chrono::seconds(5)));
+
+        std::atomic<bool> detached(false);
+        std::thread detacher([&]() {
+            scheduler.Detach(worker);
+            detached.store(true);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        CONCURRENCY_CHECK(!detached.load());
+        release.store(true);
+        detacher.join();
+        CONCURRENCY_CHECK(detached.load());
+        scheduler.Deactivate();
+    }
+
+    // A stall callback may detach the stalled job: the call returns once the execution has completed.
+    void TestDetachFromCallback()
+    {
+        std::atomic<bool> detached(false);
+        StallingWorker worker(std::chrono::milliseconds(100));
+        PooledScheduler scheduler(0, 2);
+        scheduler.Attach(worker, 0, 10, 1);
+        scheduler.Activate();
+        {
+            Watchdog watchdog(scheduler, 5, [&](const RunningJob&) {
+                scheduler.Detach(worker);
+                detached.store(true);
+            });
+            CONCURRENCY_CHECK(WaitFor([&detached]() { return detached.load(); }, std::chrono::seconds(5)));
+            CONCURRENCY_CHECK(watchdog.GetStallCount() == 1);
+        }
+        scheduler.Deactivate();
+        CONCURRENCY_CHECK(worker.runs.load() == 1);
+        CONCURRENCY_CHECK(worker.timeouts.load() == 1);
+    }
+} // namespace
+
+int main()
+{
+    TestStallNotifiedOnce();
+    TestStallNotifiedOnEndWithoutWatchdog();
+    TestDetachWaitsForCallback();
+    TestDetachFromCallback();
+    return ConcurrencyTest::Result();
+}
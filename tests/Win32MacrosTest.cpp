@@ -0,0 +1,78 @@
+// Compiles every header under the min and max function-like macros that <windows.h> defines
+// without NOMINMAX, so a call such as std::min(a, b) or T::max() reaching a header fails here
+// rather than in a Windows project including the headers after <windows.h>. The standard headers
+// come first, since the macros would break the standard library headers of other compilers too.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#endif
+#endif
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#include <Concurrency/AsyncLogSinker.hpp>
+#include <Concurrency/AtomicSharedPtr.hpp>
+#include <Concurrency/BasicScheduler.hpp>
+#include <Concurrency/ConcurrencyLog.hpp>
+#include <Concurrency/CyclicalWorker.hpp>
+#include <Concurrency/DeadlineQueue.hpp>
+#include <Concurrency/HighResolutionTimer.hpp>
+#include <Concurrency/IAsyncScheduledWorker.hpp>
+#include <Concurrency/IBatchLogSinker.hpp>
+#include <Concurrency/IScheduler.hpp>
+#include <Concurrency/ITask.hpp>
+#include <Concurrency/IdleStrategy.hpp>
+#include <Concurrency/InplaceFunction.hpp>
+#include <Concurrency/IntrusivePtr.hpp>
+#include <Concurrency/JobSpec.hpp>
+#include <Concurrency/JobStats.hpp>
+#include <Concurrency/LatencyHistogram.hpp>
+#include <Concurrency/LogFilter.hpp>
+#include <Concurrency/MpmcQueue.hpp>
+#include <Concurrency/MultiLogSinker.hpp>
+#include <Concurrency/NativeThread.hpp>
+#include <Concurrency/OpenMetricsExporter.hpp>
+#include <Concurrency/ParallelFor.hpp>
+#include <Concurrency/PooledScheduler.hpp>
+#include <Concurrency/RoutineTimeMonitor.hpp>
+#include <Concurrency/RoutineTimeSnapshot.hpp>
+#include <Concurrency/Scheduler.hpp>
+#include <Concurrency/SpscQueue.hpp>
+#include <Concurrency/StaticWorker.hpp>
+#include <Concurrency/Task.hpp>
+#include <Concurrency/TaskGraph.hpp>
+#include <Concurrency/ThreadPlacement.hpp>
+#include <Concurrency/ThreadPool.hpp>
+#include <Concurrency/TraceRecorder.hpp>
+#include <Concurrency/Watchdog.hpp>
+#include <Concurrency/WorkStealingDeque.hpp>
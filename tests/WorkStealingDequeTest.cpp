@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Concurrency/WorkStealingDeque.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace Concurrency;
+
+namespace
+{
+    void TestOwnerTakesNewestFirst()
+    {
+        WorkStealingDeque<int> deque;
+        deque.Push(1);
+        deque.Push(2);
+        deque.Push(3);
+        int item = 0;
+        CONCURRENCY_CHECK(deque.Take(item) && item == 3);
+        CONCURRENCY_CHECK(deque.Take(item) && item == 2);
+        CONCURRENCY_CHECK(deque.Take(item) && item == 1);
+        CONCURRENCY_CHECK(!deque.Take(item));
+    }
+
+    void TestThiefStealsOldestFirst()
+    {
+        WorkStealingDeque<int> deque;
+        deque.Push(1);
+        deque.Push(2);
+        int item = 0;
+        CONCURRENCY_CHECK(deque.Steal(item) && item == 1);
+        CONCURRENCY_CHECK(deque.Take(item) && item == 2);
+        CONCURRENCY_CHECK(!deque.Steal(item));
+    }
+
+    void TestGrowingKeepsItems()
+    {
+        const int count = 1000;
+        WorkStealingDeque<int> deque(4);
+        for (int value = 0; value < count; ++value)
+        {
+            deque.Push(value);
+        }
+        int item = 0;
+        int64_t sum = 0;
+        int taken = 0;
+        while (deque.Take(item))
+        {
+            sum += item;
+            ++taken;
+        }
+        CONCURRENCY_CHECK(taken == count);
+        CONCURRENCY_CHECK(sum == int64_t(count) * (count - 1) / 2);
+    }
+
+    // The owner pushes and takes while thieves steal; every item must be taken exactly once.
+    void TestEveryItemIsTakenOnce()
+    {
+        const int count = 200000;
+        const int thiefCount = 3;
+        WorkStealingDeque<int> deque(16);
+        std::vector<std::atomic<int>> seen(count);
+        std::atomic<int> taken(0);
+        std::atomic<bool> pushing(true);
+
+        std::vector<std::thread> thieves;
+        for (int thief = 0; thief < thiefCount; ++thief)
+        {
+            thieves.emplace_back([&]() {
+                int item = 0;
+                while (pushing.load() || taken.load() < count)
+                {
+                    if (deque.Steal(item))
+                    {
+                        seen[item].fetch_add(1);
+                        taken.fetch_add(1);
+                    }
+                }
+            });
+        }
+
+        int item = 0;
+        for (int value = 0; value < count; ++value)
+        {
+            deque.Push(value);
+            if (value % 3 == 0 && deque.Take(item))
+            {
+                seen[item].fetch_add(1);
+                taken.fetch_add(1);
+            }
+        }
+        pushing.store(false);
+        while (deque.Take(item))
+        {
+            seen[item].fetch_add(1);
+            taken.fetch_add(1);
+        }
+        for (std::thread& thief : thieves)
+        {
+            thief.join();
+        }
+
+        int wrong = 0;
+        for (const std::atomic<int>& times : seen)
+        {
+            wrong += times.load() != 1;
+        }
+        CONCURRENCY_CHECK(taken.load() == count);
+        CONCURRENCY_CHECK(wrong == 0);
+    }
+} // namespace
+
+int main()
+{
+    TestOwnerTakesNewestFirst();
+    TestThiefStealsOldestFirst();
+    TestGrowingKeepsItems();
+    TestEveryItemIsTakenOnce();
+    return ConcurrencyTest::Result();
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "IBatchLogSinker.hpp"
+#include "NativeThread.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief What a producer does when the queue of an AsyncLogSinker is full.
+     */
+    enum class LogOverflowPolicy : int
+    {
+        Drop,
+        Block
+    };
+
+    /**
+     * @brief A log sinker that queues messages and delivers them to another sinker on a background thread.
+     *
+     * Registered with ConcurrencyLog in place of the actual sinker, it turns every log call into a
+     * copy of the message into a preallocated record of a bounded, lock-free multi-producer ring.
+     * Logging threads therefore never take a lock, never allocate and never wait for sink I/O. The
+     * background thread drains the ring in batches and forwards every record to the target sinker.
+     * A target implementing IBatchLogSinker receives each batch with a single LogBatch call, reading
+     * the messages straight from the ring.
+     *
+     * Messages longer than MESSAGE_CAPACITY are truncated. When the ring is full, the message is
+     * either dropped and counted, or the producer waits for a free record, depending on the overflow
+     * policy. A message logged from within the target sinker itself is never waited for.
+     *
+     * The sinker must be unregistered from ConcurrencyLog before it is destroyed. Destroying it
+     * delivers the queued messages first.
+     */
+    class AsyncLogSinker : public ILogSinker
+    {
+    public:
+        /**
+         * @brief The maximum length in bytes of a queued message.
+         */
+        static constexpr std::size_t MESSAGE_CAPACITY = 240;
+
+        /**
+         * @brief Construct a new Async Log Sinker object and start its background thread.
+         *
+         * @param target The sinker receiving the messages, which must outlive this object.
+         * @param capacity The number of records of the ring, rounded up to a power of two.
+         * @param overflowPolicy Whether to drop messages or to wait when the ring is full.
+         */
+        explicit AsyncLogSinker(ILogSinker& target, std::size_t capacity = 1024,
+                                LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Drop);
+
+        /**
+         * @brief Delivers the queued messages and joins the background thread.
+         */
+        ~AsyncLogSinker() override;
+
+        AsyncLogSinker(const AsyncLogSinker&) = delete;
+        AsyncLogSinker& operator=(const AsyncLogSinker&) = delete;
+
+        /**
+         * @brief Queues a message for delivery to the target sinker.
+         *
+         * @param level The log level of the message.
+         * @param message The log message to be logged.
+         */
+        void Log(const LogLevel level, const std::string& message) override;
+
+        /**
+         * @brief Queues a message for delivery to the target sinker.
+         *
+         * @param level The log level of the message.
+         * @param message The characters of the message, not necessarily null-terminated.
+         * @param length The length of the message in bytes.
+         * @return true if the message was queued, false if it was dropped.
+         */
+        bool Log(const LogLevel level, const char* message, std::size_t length);
+
+        /**
+         * @brief Waits until every message queued before the call has been delivered.
+         */
+        void Flush();
+
+        /**
+         * @brief Gets the number of messages dropped because the ring was full.
+         *
+         * @return uint64_t The number of dropped messages.
+         */
+        uint64_t GetDroppedCount() const;
+
+    private:
+        static constexpr std::size_t DRAIN_BATCH = 64;
+
+        struct alignas(64) Record
+        {
+            std::atomic<uint64_t> sequence;
+            LogLevel level;
+            uint32_t length;
+            char text[MESSAGE_CAPACITY];
+        };
+
+        static std::size_t RoundUpCapacity(std::size_t capacity);
+
+        bool TryEnqueue(LogLevel level, const char* message, std::size_t length);
+        bool IsPublished(uint64_t position) const;
+        std::size_t DrainBatch();
+        void Deliver(std::size_t count);
+        void DrainLoop();
+
+        ILogSinker& target;
+        IBatchLogSinker* const batchTarget;
+        const LogOverflowPolicy overflowPolicy;
+        const std::size_t capacity;
+        const std::unique_ptr<Record[]> records;
+
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) uint64_t head;
+        std::string message;
+        LogRecord batch[DRAIN_BATCH];
+        std::atomic<uint64_t> delivered;
+        std::atomic<uint64_t> dropped;
+
+        std::atomic<bool> sleeping;
+        std::atomic<bool> terminated;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::condition_variable flushed;
+        std::thread thread;
+    };
+
+    inline AsyncLogSinker::AsyncLogSinker(ILogSinker& target, std::size_t capacity, LogOverflowPolicy overflowPolicy)
+        : target(target),
+          batchTarget(dynamic_cast<IBatchLogSinker*>(&target)),
+          overflowPolicy(overflowPolicy),
+          capacity(RoundUpCapacity(capacity)),
+          records(new Record[this->capacity]),
+          tail(0),
+          head(0),
+          delivered(0),
+          dropped(0),
+          sleeping(false),
+          terminated(false)
+    {
+        for (std::size_t index = 0; index < this->capacity; ++index)
+        {
+            records[index].sequence.store(index, std::memory_order_relaxed);
+        }
+        message.reserve(MESSAGE_CAPACITY);
+        thread = std::thread([this]() { DrainLoop(); });
+    }
+
+    inline AsyncLogSinker::~AsyncLogSinker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            terminated.store(true);
+        }
+        cond.notify_all();
+        thread.join();
+    }
+
+    inline void AsyncLogSinker::Log(const LogLevel level, const std::string& message)
+    {
+        Log(level, message.data(), message.size());
+    }
+
+    inline bool AsyncLogSinker::Log(const LogLevel level, const char* message, std::size_t length)
+    {
+        while (!TryEnqueue(level, message, length))
+        {
+            if (overflowPolicy == LogOverflowPolicy::Drop || std::this_thread::get_id() == thread.get_id())
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        if (sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cond.notify_one();
+        }
+        return true;
+    }
+
+    inline void AsyncLogSinker::Flush()
+    {
+        const uint64_t position = tail.load();
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.notify_one();
+        flushed.wait(lock, [this, position]() { return delivered.load() >= position || terminated.load(); });
+    }
+
+    inline uint64_t AsyncLogSinker::GetDroppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    inline std::size_t AsyncLogSinker::RoundUpCapacity(std::size_t capacity)
+    {
+        std::size_t rounded = 2;
+        while (rounded < capacity)
+        {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+
+    inline bool AsyncLogSinker::TryEnqueue(LogLevel level, const char* message, std::size_t length)
+    {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        Record* record = nullptr;
+        for (;;)
+        {
+            record = &records[position & (capacity - 1)];
+            const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+            const int64_t difference = static_cast<int64_t>(sequence - position);
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        record->level = level;
+        record->length = static_cast<uint32_t>(length < MESSAGE_CAPACITY ? length : MESSAGE_CAPACITY);
+        std::memcpy(record->text, message, record->length);
+        record->sequence.store(position + 1);
+        return true;
+    }
+
+    inline bool AsyncLogSinker::IsPublished(uint64_t position) const
+    {
+        return records[position & (capacity - 1)].sequence.load() == position + 1;
+    }
+
+    inline std::size_t AsyncLogSinker::DrainBatch()
+    {
+        std::size_t count = 0;
+        while (count < DRAIN_BATCH && IsPublished(head + count))
+        {
+            const Record& record = records[(head + count) & (capacity - 1)];
+            batch[count] = LogRecord{record.level, record.text, record.length};
+            ++count;
+        }
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        Deliver(count);
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            records[(head + index) & (capacity - 1)].sequence.store(head + index + capacity, std::memory_order_release);
+        }
+        head += count;
+        delivered.store(head);
+        std::lock_guard<std::mutex> lock(mutex);
+        flushed.notify_all();
+        return count;
+    }
+
+    inline void AsyncLogSinker::Deliver(std::size_t count)
+    {
+        if (batchTarget != nullptr)
+        {
+            try
+            {
+                batchTarget->LogBatch(batch, count);
+            }
+            catch (...)
+            {
+            }
+            return;
+        }
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            message.assign(batch[index].message, batch[index].length);
+            try
+            {
+                target.Log(batch[index].level, message);
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    inline void AsyncLogSinker::DrainLoop()
+    {
+        ThisThread::SetName("AsyncLogSinker");
+        for (;;)
+        {
+            if (DrainBatch() > 0)
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            sleeping.store(true);
+            if (!IsPublished(head))
+            {
+                if (terminated.load())
+                {
+                    break;
+                }
+                cond.wait(lock);
+            }
+            sleeping.store(false);
+        }
+        flushed.notify_all();
+    }
+} // namespace Concurrency
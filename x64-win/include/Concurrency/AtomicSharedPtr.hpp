@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace Concurrency
+{
+    /**
+     * @brief A shared_ptr that can be loaded and replaced concurrently.
+     *
+     * Used to publish copy-on-write snapshots: readers Load() the current snapshot and keep
+     * iterating it for as long as they hold the returned pointer, while writers build a new
+     * snapshot and Store() it without ever waiting for the readers.
+     *
+     * @tparam T The type of the published object.
+     */
+    template <typename T>
+    class AtomicSharedPtr
+    {
+    public:
+        /**
+         * @brief Construct a new Atomic Shared Ptr object.
+         *
+         * @param value The initially published object.
+         */
+        explicit AtomicSharedPtr(std::shared_ptr<T> value = nullptr) : value(std::move(value))
+        {
+        }
+
+        AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+        AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+        /**
+         * @brief Gets the currently published object.
+         *
+         * @return std::shared_ptr<T> The published object.
+         */
+        std::shared_ptr<T> Load() const
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return value.load(std::memory_order_acquire);
+#else
+            return std::atomic_load_explicit(&value, std::memory_order_acquire);
+#endif
+        }
+
+        /**
+         * @brief Publishes a new object.
+         *
+         * @param desired The object to be published.
+         */
+        void Store(std::shared_ptr<T> desired)
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            value.store(std::move(desired), std::memory_order_release);
+#else
+            std::atomic_store_explicit(&value, std::move(desired), std::memory_order_release);
+#endif
+        }
+
+    private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<std::shared_ptr<T>> value;
+#else
+        std::shared_ptr<T> value;
+#endif
+    };
+} // namespace Concurrency
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Concurrency
+{
+    /**
+     * @brief The position tracking of a DeadlineQueue whose values do not need to know where they are.
+     */
+    struct UntrackedPosition
+    {
+        template <typename Value>
+        static void Placed(Value&, std::size_t)
+        {
+        }
+
+        template <typename Value>
+        static void Removed(Value&)
+        {
+        }
+    };
+
+    /**
+     * @brief A binary min-heap of values ordered by their deadline.
+     *
+     * Push and Pop are O(log n) and the earliest deadline is available in O(1), which lets a
+     * dispatch loop sleep exactly until the next job is due instead of polling every entry.
+     * The deadlines and the values are kept in two parallel arrays, so sifting through the heap
+     * compares densely packed deadlines and never dereferences a value. The queue is not
+     * thread-safe.
+     *
+     * A Tracker other than UntrackedPosition is told the index of a value every time the value
+     * lands somewhere in the heap, and when it leaves the heap. Values that remember their index
+     * can then be moved to another deadline with Update() or removed with Erase() in O(log n),
+     * rather than pushed a second time.
+     *
+     * @tparam Value The type stored alongside each deadline.
+     * @tparam Clock The clock the deadlines refer to.
+     * @tparam Tracker A type with static Placed(Value&, std::size_t index) and Removed(Value&).
+     */
+    template <typename Value, typename Clock = std::chrono::steady_clock, typename Tracker = UntrackedPosition>
+    class DeadlineQueue
+    {
+    public:
+        typedef typename Clock::time_point TimePoint;
+
+        /**
+         * @brief Inserts a value due at the specified deadline.
+         *
+         * @param deadline The point in time the value becomes due.
+         * @param value The value to be inserted.
+         * @return true if the value became the earliest entry of the queue.
+         */
+        bool Push(const TimePoint& deadline, Value value)
+        {
+            deadlines.push_back(deadline);
+            values.push_back(std::move(value));
+            return SiftUp(deadlines.size() - 1) == 0;
+        }
+
+        /**
+         * @brief Gets the earliest deadline. The queue must not be empty.
+         *
+         * @return const TimePoint& The earliest deadline in the queue.
+         */
+        const TimePoint& TopDeadline() const
+        {
+            return deadlines.front();
+        }
+
+        /**
+         * @brief Gets the value with the earliest deadline. The queue must not be empty.
+         *
+         * @return Value& The value with the earliest deadline.
+         */
+        Value& Top()
+        {
+            return values.front();
+        }
+
+        /**
+         * @brief Removes the value with the earliest deadline and returns it. The queue must not be empty.
+         *
+         * @return Value The removed value.
+         */
+        Value Pop()
+        {
+            Value value = std::move(values.front());
+            Tracker::Removed(value);
+            const TimePoint lastDeadline = deadlines.back();
+            Value lastValue = std::move(values.back());
+            deadlines.pop_back();
+            values.pop_back();
+            if (!deadlines.empty())
+            {
+                SiftDown(0, lastDeadline, std::move(lastValue));
+            }
+            return value;
+        }
+
+        /**
+         * @brief Gets the deadline of the entry at an index, as reported to the Tracker.
+         *
+         * @param index The index of the entry, which must be in the queue.
+         * @return const TimePoint& The deadline of the entry.
+         */
+        const TimePoint& DeadlineAt(std::size_t index) const
+        {
+            return deadlines[index];
+        }
+
+        /**
+         * @brief Moves the entry at an index to a new deadline, earlier or later.
+         *
+         * @param index The index of the entry, which must be in the queue.
+         * @param deadline The new deadline of the entry.
+         */
+        void Update(std::size_t index, const TimePoint& deadline)
+        {
+            Value value = std::move(values[index]);
+            Place(index, deadline, std::move(value));
+        }
+
+        /**
+         * @brief Removes the entry at an index and returns its value.
+         *
+         * @param index The index of the entry, which must be in the queue.
+         * @return Value The removed value.
+         */
+        Value Erase(std::size_t index)
+        {
+            Value value = std::move(values[index]);
+            Tracker::Removed(value);
+            const TimePoint lastDeadline = deadlines.back();
+            Value lastValue = std::move(values.back());
+            deadlines.pop_back();
+            values.pop_back();
+            if (index < deadlines.size())
+            {
+                Place(index, lastDeadline, std::move(lastValue));
+            }
+            return value;
+        }
+
+        /**
+         * @brief Moves the value with the earliest deadline to a new deadline. The queue must not be empty.
+         *
+         * Equivalent to pushing the popped value again, at the cost of a single sift.
+         *
+         * @param deadline The new deadline of the earliest value.
+         */
+        void ReplaceTop(const TimePoint& deadline)
+        {
+            Value value = std::move(values.front());
+            SiftDown(0, deadline, std::move(value));
+        }
+
+        /**
+         * @brief Checks whether the queue holds any entries.
+         *
+         * @return true if the queue is empty.
+         */
+        bool Empty() const
+        {
+            return deadlines.empty();
+        }
+
+        /**
+         * @brief Gets the number of entries in the queue.
+         *
+         * @return std::size_t The number of entries.
+         */
+        std::size_t Size() const
+        {
+            return deadlines.size();
+        }
+
+        /**
+         * @brief Reserves storage for the specified number of entries.
+         *
+         * @param capacity The number of entries to reserve storage for.
+         */
+        void Reserve(std::size_t capacity)
+        {
+            deadlines.reserve(capacity);
+            values.reserve(capacity);
+        }
+
+        /**
+         * @brief Removes all entries.
+         */
+        void Clear()
+        {
+            for (Value& value : values)
+            {
+                Tracker::Removed(value);
+            }
+            deadlines.clear();
+            values.clear();
+        }
+
+    private:
+        void Place(std::size_t index, const TimePoint& deadline, Value value)
+        {
+            if (index > 0 && deadline < deadlines[(index - 1) / 2])
+            {
+                deadlines[index] = deadline;
+                values[index] = std::move(value);
+                SiftUp(index);
+            }
+            else
+            {
+                SiftDown(index, deadline, std::move(value));
+            }
+        }
+
+        std::size_t SiftUp(std::size_t index)
+        {
+            const TimePoint deadline = deadlines[index];
+            Value value = std::move(values[index]);
+            while (index > 0)
+            {
+                const std::size_t parent = (index - 1) / 2;
+                if (!(deadline < deadlines[parent]))
+                {
+                    break;
+                }
+                deadlines[index] = deadlines[parent];
+                values[index] = std::move(values[parent]);
+                Tracker::Placed(values[index], index);
+                index = parent;
+            }
+            deadlines[index] = deadline;
+            values[index] = std::move(value);
+            Tracker::Placed(values[index], index);
+            return index;
+        }
+
+        void SiftDown(std::size_t index, const TimePoint deadline, Value value)
+        {
+            const std::size_t count = deadlines.size();
+            for (;;)
+            {
+                std::size_t child = 2 * index + 1;
+                if (child >= count)
+                {
+                    break;
+                }
+                if (child + 1 < count && deadlines[child + 1] < deadlines[child])
+                {
+                    ++child;
+                }
+                if (!(deadlines[child] < deadline))
+                {
+                    break;
+                }
+                deadlines[index] = deadlines[child];
+                values[index] = std::move(values[child]);
+                Tracker::Placed(values[index], index);
+                index = child;
+            }
+            deadlines[index] = deadline;
+            values[index] = std::move(value);
+            Tracker::Placed(values[index], index);
+        }
+
+        std::vector<TimePoint> deadlines;
+        std::vector<Value> values;
+    };
+} // namespace Concurrency
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "IScheduler.hpp"
+#include "NativeThread.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <time.h>
+
+#include <cerrno>
+#endif
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace Concurrency
+{
+    /**
+     * @brief How precisely the dispatch thread of a PooledScheduler wakes up for its deadlines.
+     */
+    struct DispatchTiming
+    {
+        /**
+         * @brief The time in microseconds before a deadline from which the dispatch thread leaves
+         * its condition variable for a HighResolutionTimer. 0 keeps waiting on the condition
+         * variable alone, whose wakeups can be late by a scheduler tick.
+         *
+         * New jobs and deadlines posted during that window are only seen once it has passed.
+         */
+        Microsecond preciseWindow = 0;
+
+        /**
+         * @brief The time in microseconds before a deadline from which the dispatch thread spins
+         * instead of sleeping, trading one busy core for wakeups without timer latency.
+         */
+        Microsecond spinPhase = 0;
+    };
+
+    /**
+     * @brief Sleeps the calling thread until a point of the steady clock with sub-millisecond precision.
+     *
+     * On Windows it waits on a high-resolution waitable timer, which is not bound to the system
+     * timer tick, falling back to a regular waitable timer on systems without support. On Linux it
+     * sleeps on the monotonic clock with an absolute deadline. The final part of a wait can be
+     * spent spinning to absorb the remaining wakeup latency.
+     *
+     * An instance is used by one thread at a time.
+     */
+    class HighResolutionTimer
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        HighResolutionTimer();
+        ~HighResolutionTimer();
+
+        HighResolutionTimer(const HighResolutionTimer&) = delete;
+        HighResolutionTimer& operator=(const HighResolutionTimer&) = delete;
+
+        /**
+         * @brief Sleeps until a deadline.
+         *
+         * @param deadline The time to wake up at. Returns immediately if it has passed.
+         */
+        void SleepUntil(const Clock::time_point& deadline);
+
+        /**
+         * @brief Sleeps until shortly before a deadline, then spins until the deadline.
+         *
+         * @param deadline The time to return at.
+         * @param spinPhase The final part of the wait spent spinning.
+         */
+        void WaitUntil(const Clock::time_point& deadline, std::chrono::microseconds spinPhase);
+
+        /**
+         * @brief Busy-waits until a deadline.
+         *
+         * @param deadline The time to return at.
+         */
+        static void SpinUntil(const Clock::time_point& deadline);
+
+    private:
+#if defined(_WIN32)
+        HANDLE timer;
+#endif
+    };
+
+    inline HighResolutionTimer::HighResolutionTimer()
+    {
+#if defined(_WIN32)
+        timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (timer == nullptr)
+        {
+            timer = ::CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+#endif
+    }
+
+    inline HighResolutionTimer::~HighResolutionTimer()
+    {
+#if defined(_WIN32)
+        if (timer != nullptr)
+        {
+            ::CloseHandle(timer);
+        }
+#endif
+    }
+
+    inline void HighResolutionTimer::SleepUntil(const Clock::time_point& deadline)
+    {
+        const Clock::duration remaining = deadline - Clock::now();
+        if (remaining <= Clock::duration::zero())
+        {
+            return;
+        }
+#if defined(_WIN32)
+        if (timer != nullptr)
+        {
+            // Negative due times are relative, in units of 100 nanoseconds.
+            LARGE_INTEGER dueTime;
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            dueTime.QuadPart = -static_cast<LONGLONG>(nanoseconds / 100);
+            if (dueTime.QuadPart < 0 && ::SetWaitableTimer(timer, &dueTime, 0, nullptr, nullptr, FALSE))
+            {
+                ::WaitForSingleObject(timer, INFINITE);
+                return;
+            }
+        }
+        std::this_thread::sleep_until(deadline);
+#elif defined(__linux__)
+        timespec target;
+        ::clock_gettime(CLOCK_MONOTONIC, &target);
+        const int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        target.tv_sec += static_cast<time_t>(nanoseconds / 1000000000);
+        target.tv_nsec += static_cast<long>(nanoseconds % 1000000000);
+        if (target.tv_nsec >= 1000000000)
+        {
+            target.tv_nsec -= 1000000000;
+            ++target.tv_sec;
+        }
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR)
+        {
+        }
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+
+    inline void HighResolutionTimer::WaitUntil(const Clock::time_point& deadline, std::chrono::microseconds spinPhase)
+    {
+        SleepUntil(deadline - spinPhase);
+        SpinUntil(deadline);
+    }
+
+    inline void HighResolutionTimer::SpinUntil(const Clock::time_point& deadline)
+    {
+        while (Clock::now() < deadline)
+        {
+            ThisThread::CpuRelax();
+        }
+    }
+} // namespace Concurrency
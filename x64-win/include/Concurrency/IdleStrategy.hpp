@@ -0,0 +1,85 @@
+#pragma once
+
+#include "IScheduler.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief How an idle worker thread of a ThreadPool waits for its next task.
+     *
+     * Parking on the condition variable costs nothing while idle, but every wakeup pays a kernel
+     * round trip, which for a loop of a millisecond or less is a large part of its jitter. A pool
+     * running latency-critical jobs can instead keep its idle threads spinning, so a submitted
+     * task is picked up within nanoseconds and the submitter skips the notification, at the cost
+     * of one busy core per spinning thread.
+     */
+    struct IdleStrategy
+    {
+        enum class Mode : int
+        {
+            /**
+             * @brief Idle threads park on the condition variable at once.
+             */
+            Park,
+            /**
+             * @brief Idle threads spin with a pause instruction and never park.
+             */
+            BusySpin,
+            /**
+             * @brief Idle threads spin with a pause instruction for the spin phase, then yield
+             * their time slice for the yield phase, then park.
+             *
+             * Every thread keeps an average of its observed idle gaps and parks at once while
+             * that average is longer than both phases together, so a thread of a pool running
+             * only slow or sporadic jobs keeps sleeping.
+             */
+            Backoff
+        };
+
+        /**
+         * @brief Construct a strategy parking at once.
+         */
+        IdleStrategy() : mode(Mode::Park), spinPhase(0), yieldPhase(0)
+        {
+        }
+
+        /**
+         * @brief Idle threads park at once.
+         */
+        static IdleStrategy Parking()
+        {
+            return IdleStrategy();
+        }
+
+        /**
+         * @brief Idle threads never leave the processor.
+         */
+        static IdleStrategy BusySpinning()
+        {
+            IdleStrategy strategy;
+            strategy.mode = Mode::BusySpin;
+            return strategy;
+        }
+
+        /**
+         * @brief Idle threads spin, then yield, then park.
+         *
+         * @param spinPhase The time in microseconds spent spinning after a thread became idle.
+         * @param yieldPhase The time in microseconds spent yielding after the spin phase. Giving
+         * both phases together a bit more than the interval of the jobs keeps their threads
+         * from parking between executions.
+         */
+        static IdleStrategy BackingOff(Microsecond spinPhase, Microsecond yieldPhase)
+        {
+            IdleStrategy strategy;
+            strategy.mode = Mode::Backoff;
+            strategy.spinPhase = spinPhase;
+            strategy.yieldPhase = yieldPhase;
+            return strategy;
+        }
+
+        Mode mode;
+        Microsecond spinPhase;
+        Microsecond yieldPhase;
+    };
+} // namespace Concurrency
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace Concurrency
+{
+    /**
+     * @brief A smart pointer to an object that keeps its own reference count.
+     *
+     * Unlike std::shared_ptr there is no separate control block: the pointer is a single word and
+     * copying it only touches the counter of the object. The pointed-to type provides AddRef() and
+     * Release(), and Release() destroys the object once the last reference is gone.
+     *
+     * @tparam T The type of the referenced object.
+     */
+    template <typename T>
+    class IntrusivePtr
+    {
+    public:
+        /**
+         * @brief Construct an empty Intrusive Ptr object.
+         */
+        IntrusivePtr() noexcept : pointer(nullptr)
+        {
+        }
+
+        /**
+         * @brief Construct an empty Intrusive Ptr object.
+         */
+        IntrusivePtr(std::nullptr_t) noexcept : pointer(nullptr)
+        {
+        }
+
+        /**
+         * @brief Construct a new Intrusive Ptr object referencing an object.
+         *
+         * @param pointer The object to be referenced, may be nullptr.
+         */
+        explicit IntrusivePtr(T* pointer) noexcept : pointer(pointer)
+        {
+            if (pointer != nullptr)
+            {
+                pointer->AddRef();
+            }
+        }
+
+        IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other.pointer)
+        {
+        }
+
+        IntrusivePtr(IntrusivePtr&& other) noexcept : pointer(other.pointer)
+        {
+            other.pointer = nullptr;
+        }
+
+        IntrusivePtr& operator=(const IntrusivePtr& other) noexcept
+        {
+            IntrusivePtr(other).Swap(*this);
+            return *this;
+        }
+
+        IntrusivePtr& operator=(IntrusivePtr&& other) noexcept
+        {
+            IntrusivePtr(std::move(other)).Swap(*this);
+            return *this;
+        }
+
+        IntrusivePtr& operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        ~IntrusivePtr()
+        {
+            if (pointer != nullptr)
+            {
+                pointer->Release();
+            }
+        }
+
+        /**
+         * @brief Drops the reference, leaving the pointer empty.
+         */
+        void Reset() noexcept
+        {
+            IntrusivePtr().Swap(*this);
+        }
+
+        /**
+         * @brief Exchanges the referenced objects of two pointers.
+         */
+        void Swap(IntrusivePtr& other) noexcept
+        {
+            std::swap(pointer, other.pointer);
+        }
+
+        T* get() const noexcept
+        {
+            return pointer;
+        }
+
+        T& operator*() const noexcept
+        {
+            return *pointer;
+        }
+
+        T* operator->() const noexcept
+        {
+            return pointer;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return pointer != nullptr;
+        }
+
+        friend bool operator==(const IntrusivePtr& left, const IntrusivePtr& right) noexcept
+        {
+            return left.pointer == right.pointer;
+        }
+
+        friend bool operator!=(const IntrusivePtr& left, const IntrusivePtr& right) noexcept
+        {
+            return left.pointer != right.pointer;
+        }
+
+    private:
+        T* pointer;
+    };
+} // namespace Concurrency
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <string>
+
+#include "IScheduler.hpp"
+#include "ThreadPlacement.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief How the deadline of the next execution of a job is derived.
+     */
+    enum class TimingMode : int
+    {
+        /**
+         * @brief The next execution is due one interval after the current one was dispatched, so
+         * dispatch delays accumulate.
+         */
+        Relative,
+        /**
+         * @brief The executions are due at fixed multiples of the interval from the first one, so
+         * a late dispatch does not shift the following deadlines.
+         */
+        FixedRate
+    };
+
+    /**
+     * @brief What a job does about the executions it missed once it was a whole interval or more
+     * behind, after an overrunning execution or a stall of the process.
+     *
+     * The missed executions fall on the slots one interval apart from the last dispatch. A job
+     * never runs concurrently with itself, so the executions of one job are never a burst across
+     * the pool.
+     */
+    enum class CatchUpPolicy : int
+    {
+        /**
+         * @brief Every missed slot is executed, back to back, until the job has caught up.
+         */
+        FireAll,
+        /**
+         * @brief The missed slots are executed once, then the job continues on its next slot.
+         */
+        FireOnce,
+        /**
+         * @brief The missed slots are dropped and counted as one interval fault, and the job
+         * continues on its next slot.
+         */
+        SkipToNext
+    };
+
+    /**
+     * @brief Describes one job to be attached to a PooledScheduler.
+     *
+     * A job either hosts an existing scheduled worker, or runs an action under a name with an
+     * optional timeout callback, mirroring the IScheduler::Attach overloads.
+     */
+    struct JobSpec
+    {
+        /**
+         * @brief Describes a job hosting a scheduled worker.
+         *
+         * @param scheduleItem The scheduled worker to attach, which must outlive the job.
+         * @param interval The interval in milliseconds between each execution of the worker.
+         * @param threadPriority The priority requested for the worker.
+         * @param duration The maximum expected duration of one execution, 0 disables the timeout notification.
+         */
+        JobSpec(IScheduledWorker& scheduleItem, Millisecond interval, TaskPriority threadPriority,
+                Millisecond duration = 0)
+            : worker(&scheduleItem),
+              interval(interval),
+              threadPriority(threadPriority),
+              duration(duration),
+              preciseInterval(0),
+              timing(TimingMode::Relative),
+              catchUp(CatchUpPolicy::FireOnce),
+              latencyHistograms(false),
+              cpuAccounting(false),
+              triggered(false)
+        {
+        }
+
+        /**
+         * @brief Describes a job running an action.
+         *
+         * @param name The name of the task.
+         * @param action The action to be executed by the task.
+         * @param interval The interval in milliseconds between each execution of the task.
+         * @param threadPriority The priority requested for the task.
+         * @param callback The callback to be called with the timeout state after every execution, an execution
+         * times out when it takes longer than the interval.
+         */
+        JobSpec(const char* name, Action action, Millisecond interval, TaskPriority threadPriority,
+                TimeoutCallback callback = TimeoutCallback())
+            : worker(nullptr),
+              name(name == nullptr ? "" : name),
+              action(std::move(action)),
+              callback(std::move(callback)),
+              interval(interval),
+              threadPriority(threadPriority),
+              duration(this->callback ? interval : 0),
+              preciseInterval(0),
+              timing(TimingMode::Relative),
+              catchUp(CatchUpPolicy::FireOnce),
+              latencyHistograms(false),
+              cpuAccounting(false),
+              triggered(false)
+        {
+        }
+
+        IScheduledWorker* worker;
+        std::string name;
+        Action action;
+        TimeoutCallback callback;
+        Millisecond interval;
+        TaskPriority threadPriority;
+        Millisecond duration;
+
+        /**
+         * @brief The interval in microseconds, replacing interval when not 0.
+         */
+        Microsecond preciseInterval;
+
+        /**
+         * @brief How the deadlines of the job are derived from its interval.
+         */
+        TimingMode timing;
+
+        /**
+         * @brief What the job does about executions it fell behind on.
+         */
+        CatchUpPolicy catchUp;
+
+        /**
+         * @brief Whether the job records its durations and intervals into latency histograms.
+         */
+        bool latencyHistograms;
+
+        /**
+         * @brief Whether the job accounts the processor time and context switches of every
+         * execution into its statistics, at the cost of a few system calls per execution.
+         */
+        bool cpuAccounting;
+
+        /**
+         * @brief Whether the job runs when notified rather than on its interval, see
+         * PooledScheduler::AttachTriggered().
+         *
+         * The interval becomes the longest time the job waits for a notification after its last
+         * execution before it runs anyway, 0 to wait indefinitely.
+         */
+        bool triggered;
+
+        /**
+         * @brief The processors the job runs on, any pool thread by default.
+         */
+        ThreadPlacement placement;
+    };
+} // namespace Concurrency
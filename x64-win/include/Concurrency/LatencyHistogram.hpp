@@ -0,0 +1,279 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Concurrency
+{
+    /**
+     * @brief A fixed-memory histogram of latencies with a bounded relative error, in the style of HDR histograms.
+     *
+     * Values below 2^SubBucketBits are counted exactly. Larger values fall into logarithmic ranges,
+     * each split into 2^(SubBucketBits - 1) linear buckets, so a recorded value is known to within
+     * a relative error of 2^-(SubBucketBits - 1). Values above 2^MaxValueBits - 1 are counted as the
+     * maximum. The memory use is fixed at construction and no raw samples are stored.
+     *
+     * Record() and Reset() must be called from one thread at a time. The counters are relaxed
+     * atomics, so the query methods and CopyTo() are safe from any thread; a query that races a
+     * Record() sees every counter either before or after it.
+     *
+     * Windows are taken with LatencyWindow, which subtracts the previous copy of a histogram from
+     * the current one instead of resetting the histogram under its writer.
+     *
+     * @tparam SubBucketBits The precision, 6 keeps the relative error below 3.2%.
+     * @tparam MaxValueBits The number of bits of the largest trackable value, 32 covers 71 minutes in microseconds.
+     */
+    template <unsigned SubBucketBits = 6, unsigned MaxValueBits = 32>
+    class LatencyHistogram
+    {
+        static_assert(SubBucketBits >= 2 && SubBucketBits < MaxValueBits, "invalid histogram precision");
+        static_assert(MaxValueBits <= 63, "the largest trackable value must fit into 63 bits");
+
+    public:
+        static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MaxValueBits) - 1;
+        static constexpr std::size_t BUCKET_COUNT = (MaxValueBits - SubBucketBits + 2) * (std::size_t(1) << (SubBucketBits - 1));
+
+        /**
+         * @brief Construct an empty Latency Histogram object.
+         */
+        LatencyHistogram() : totalCount(0)
+        {
+            for (auto& count : counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        /**
+         * @brief Counts one occurrence of a value.
+         *
+         * @param value The value to be recorded, clamped to MAX_VALUE.
+         */
+        void Record(uint64_t value)
+        {
+            std::atomic<uint64_t>& count = counts[BucketIndex(value)];
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            totalCount.store(totalCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Clears every counter.
+         */
+        void Reset()
+        {
+            for (auto& count : counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+            totalCount.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the number of recorded values.
+         *
+         * @return uint64_t The number of recorded values.
+         */
+        uint64_t GetTotalCount() const
+        {
+            return totalCount.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the value below or at which a percentage of the recorded values lie.
+         *
+         * @param percentile The percentile in the range [0, 100], for example 99.9.
+         * @return uint64_t The highest value equivalent to the percentile's bucket, 0 if the histogram is empty.
+         */
+        uint64_t GetValueAtPercentile(double percentile) const
+        {
+            uint64_t total = 0;
+            for (const auto& count : counts)
+            {
+                total += count.load(std::memory_order_relaxed);
+            }
+            if (total == 0)
+            {
+                return 0;
+            }
+            percentile = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+            uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+            rank = rank == 0 ? 1 : (rank > total ? total : rank);
+
+            uint64_t seen = 0;
+            for (std::size_t index = 0; index < BUCKET_COUNT; ++index)
+            {
+                seen += counts[index].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                {
+                    return HighestEquivalentValue(index);
+                }
+            }
+            return MAX_VALUE;
+        }
+
+        /**
+         * @brief Gets the highest recorded value, to within the precision of the histogram.
+         *
+         * @return uint64_t The highest recorded value, 0 if the histogram is empty.
+         */
+        uint64_t GetMaxValue() const
+        {
+            for (std::size_t index = BUCKET_COUNT; index > 0; --index)
+            {
+                if (counts[index - 1].load(std::memory_order_relaxed) != 0)
+                {
+                    return HighestEquivalentValue(index - 1);
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Overwrites another histogram with the counters of this one.
+         *
+         * @param target The histogram receiving the counters, which must not be recorded into concurrently.
+         */
+        void CopyTo(LatencyHistogram& target) const
+        {
+            uint64_t total = 0;
+            for (std::size_t index = 0; index < BUCKET_COUNT; ++index)
+            {
+                const uint64_t count = counts[index].load(std::memory_order_relaxed);
+                target.counts[index].store(count, std::memory_order_relaxed);
+                total += count;
+            }
+            target.totalCount.store(total, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Adds the counters of another histogram, for example to aggregate several jobs.
+         *
+         * @param other The histogram whose counters are added, which may be recorded into concurrently.
+         */
+        void Add(const LatencyHistogram& other)
+        {
+            uint64_t total = 0;
+            for (std::size_t index = 0; index < BUCKET_COUNT; ++index)
+            {
+                const uint64_t count = counts[index].load(std::memory_order_relaxed) +
+                                       other.counts[index].load(std::memory_order_relaxed);
+                counts[index].store(count, std::memory_order_relaxed);
+                total += count;
+            }
+            totalCount.store(total, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Subtracts the counters of an earlier copy of the same histogram.
+         *
+         * @param earlier The earlier copy, whose counters do not exceed the counters of this histogram.
+         */
+        void Subtract(const LatencyHistogram& earlier)
+        {
+            uint64_t total = 0;
+            for (std::size_t index = 0; index < BUCKET_COUNT; ++index)
+            {
+                const uint64_t count = counts[index].load(std::memory_order_relaxed) -
+                                       earlier.counts[index].load(std::memory_order_relaxed);
+                counts[index].store(count, std::memory_order_relaxed);
+                total += count;
+            }
+            totalCount.store(total, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the index of the bucket counting a value.
+         */
+        static std::size_t BucketIndex(uint64_t value)
+        {
+            if (value > MAX_VALUE)
+            {
+                value = MAX_VALUE;
+            }
+            if (value < SUB_BUCKET_COUNT)
+            {
+                return static_cast<std::size_t>(value);
+            }
+            const unsigned exponent = HighestBit(value) - (SubBucketBits - 1);
+            return exponent * HALF_SUB_BUCKET_COUNT + static_cast<std::size_t>(value >> exponent);
+        }
+
+        /**
+         * @brief Gets the highest value counted by a bucket.
+         */
+        static uint64_t HighestEquivalentValue(std::size_t index)
+        {
+            if (index < SUB_BUCKET_COUNT)
+            {
+                return index;
+            }
+            const unsigned exponent = static_cast<unsigned>(index / HALF_SUB_BUCKET_COUNT - 1);
+            const uint64_t subBucket = index % HALF_SUB_BUCKET_COUNT + HALF_SUB_BUCKET_COUNT;
+            return ((subBucket + 1) << exponent) - 1;
+        }
+
+    private:
+        static constexpr std::size_t SUB_BUCKET_COUNT = std::size_t(1) << SubBucketBits;
+        static constexpr std::size_t HALF_SUB_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+
+        static unsigned HighestBit(uint64_t value)
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+            unsigned long index = 0;
+            if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+            {
+                return static_cast<unsigned>(index) + 32;
+            }
+            _BitScanReverse(&index, static_cast<unsigned long>(value));
+            return static_cast<unsigned>(index);
+#else
+            return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+        }
+
+        std::atomic<uint64_t> counts[BUCKET_COUNT];
+        std::atomic<uint64_t> totalCount;
+    };
+
+    /**
+     * @brief Turns a continuously recorded histogram into consecutive windows.
+     *
+     * Every call to Advance() yields the values recorded since the previous call, without ever
+     * resetting the histogram under its writer. Owned by the reading thread.
+     *
+     * @tparam Histogram The LatencyHistogram type being windowed.
+     */
+    template <typename Histogram>
+    class LatencyWindow
+    {
+    public:
+        /**
+         * @brief Closes the current window.
+         *
+         * @param live The histogram being recorded into.
+         * @return const Histogram& The values recorded into the live histogram since the previous call.
+         */
+        const Histogram& Advance(const Histogram& live)
+        {
+            live.CopyTo(window);
+            window.Subtract(recorded);
+            recorded.Add(window);
+            return window;
+        }
+
+    private:
+        Histogram recorded;
+        Histogram window;
+    };
+} // namespace Concurrency
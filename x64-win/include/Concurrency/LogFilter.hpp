@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include "ConcurrencyLog.hpp"
+
+/**
+ * @brief The lowest log level compiled into LogFilter calls, as the integer value of a LogLevel.
+ *
+ * Calls below this level compile to nothing. Defaults to Info in NDEBUG builds and to Trace otherwise.
+ */
+#ifndef CONCURRENCY_LOG_COMPILED_LEVEL
+#if defined(NDEBUG)
+#define CONCURRENCY_LOG_COMPILED_LEVEL 2
+#else
+#define CONCURRENCY_LOG_COMPILED_LEVEL 0
+#endif
+#endif
+
+namespace Concurrency
+{
+    /**
+     * @brief Level filtering and lazy formatting in front of ConcurrencyLog.
+     *
+     * A message passes two thresholds before it is formatted: the compile-time level set by
+     * CONCURRENCY_LOG_COMPILED_LEVEL, below which the call is discarded by the compiler, and the
+     * runtime minimum level, which is a single relaxed load. The message itself is only built once
+     * both have passed, so disabled diagnostics cost nothing even in hot loops.
+     */
+    class LogFilter
+    {
+    public:
+        /**
+         * @brief The lowest level compiled in.
+         */
+        static constexpr LogLevel COMPILED_LEVEL = static_cast<LogLevel>(CONCURRENCY_LOG_COMPILED_LEVEL);
+
+        /**
+         * @brief The size of the stack buffer Format() writes into before it falls back to the heap.
+         */
+        static constexpr std::size_t FORMAT_BUFFER_SIZE = 256;
+
+        /**
+         * @brief Checks whether a level is compiled in.
+         */
+        static constexpr bool IsCompiled(LogLevel level)
+        {
+            return static_cast<int>(level) >= static_cast<int>(COMPILED_LEVEL);
+        }
+
+        /**
+         * @brief Sets the runtime minimum level. Messages below it are neither formatted nor logged.
+         *
+         * @param level The lowest level to be logged.
+         */
+        static void SetMinimumLevel(LogLevel level)
+        {
+            MinimumLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the runtime minimum level.
+         *
+         * @return LogLevel The lowest level to be logged.
+         */
+        static LogLevel GetMinimumLevel()
+        {
+            return static_cast<LogLevel>(MinimumLevel().load(std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Checks whether a message of a level would be logged.
+         */
+        static bool IsEnabled(LogLevel level)
+        {
+            return IsCompiled(level) && static_cast<int>(level) >= MinimumLevel().load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Logs a ready-made message if its level is enabled.
+         *
+         * @param level The log level of the message.
+         * @param message The log message to be logged.
+         */
+        static void Log(LogLevel level, const std::string& message)
+        {
+            if (IsEnabled(level))
+            {
+                ConcurrencyLog::GetInstance().Log(level, message);
+            }
+        }
+
+        /**
+         * @brief Logs the message produced by a formatter, calling it only if the level is enabled.
+         *
+         * @tparam Level The log level of the message.
+         * @param formatter A callable returning the message as a std::string.
+         */
+        template <LogLevel Level, typename Formatter>
+        static void Log(Formatter&& formatter)
+        {
+            if constexpr (IsCompiled(Level))
+            {
+                if (IsEnabled(Level))
+                {
+                    ConcurrencyLog::GetInstance().Log(Level, std::forward<Formatter>(formatter)());
+                }
+            }
+        }
+
+        /**
+         * @brief Logs a printf-style message, formatting it only if the level is enabled.
+         *
+         * @tparam Level The log level of the message.
+         * @param format The printf format string.
+         * @param args The arguments referenced by the format string.
+         */
+        template <LogLevel Level, typename... Args>
+        static void Format(const char* format, Args... args)
+        {
+            if constexpr (IsCompiled(Level))
+            {
+                if (IsEnabled(Level))
+                {
+                    ConcurrencyLog::GetInstance().Log(Level, FormatMessage(format, args...));
+                }
+            }
+        }
+
+    private:
+        static std::atomic<int>& MinimumLevel()
+        {
+            static std::atomic<int> minimumLevel(static_cast<int>(LogLevel::Trace));
+            return minimumLevel;
+        }
+
+        template <typename... Args>
+        static std::string FormatMessage(const char* format, Args... args)
+        {
+            char buffer[FORMAT_BUFFER_SIZE];
+            const int length = std::snprintf(buffer, sizeof(buffer), format, args...);
+            if (length < 0)
+            {
+                return std::string(format);
+            }
+            if (static_cast<std::size_t>(length) < sizeof(buffer))
+            {
+                return std::string(buffer, static_cast<std::size_t>(length));
+            }
+            std::string message(static_cast<std::size_t>(length), '\0');
+            std::snprintf(&message[0], message.size() + 1, format, args...);
+            return message;
+        }
+    };
+} // namespace Concurrency
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Concurrency
+{
+    /**
+     * @brief A bounded lock-free ring queue for any number of producer and consumer threads.
+     *
+     * Every slot carries a sequence number telling producers and consumers in which lap of the
+     * ring it is free or filled, so a push or pop is a single compare-and-swap on its end's index
+     * followed by plain accesses to the claimed slot, without any lock. The two indices live on
+     * cache lines of their own. The batch operations claim a run of consecutive slots with one
+     * compare-and-swap.
+     *
+     * The queue is not linearizable across an item being pushed: a consumer may briefly see the
+     * queue as empty while a producer that claimed the next slot is still writing it.
+     *
+     * @tparam T The item type, which must be default constructible and move assignable.
+     */
+    template <typename T>
+    class MpmcQueue
+    {
+    public:
+        /**
+         * @brief Construct a new Mpmc Queue object.
+         *
+         * @param capacity The maximum number of queued items, rounded up to a power of two.
+         */
+        explicit MpmcQueue(std::size_t capacity) : enqueuePosition(0), dequeuePosition(0)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            mask = size - 1;
+            slots.reset(new Slot[size]);
+            for (std::size_t index = 0; index < size; ++index)
+            {
+                slots[index].sequence.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        /**
+         * @brief Appends an item. Safe from any thread.
+         *
+         * @param item The item to be appended, left untouched if the queue is full.
+         * @return false if the queue is full.
+         */
+        bool TryPush(T&& item)
+        {
+            return PushBatch(&item, 1) == 1;
+        }
+
+        /**
+         * @brief Appends a copy of an item. Safe from any thread.
+         */
+        bool TryPush(const T& item)
+        {
+            T copy(item);
+            return TryPush(std::move(copy));
+        }
+
+        /**
+         * @brief Appends as many items of an array as there are consecutive free slots. Safe from any thread.
+         *
+         * @param items The items to be appended; the appended ones are moved from.
+         * @param count The number of items in the array.
+         * @return std::size_t The number of items appended, from the start of the array.
+         */
+        std::size_t PushBatch(T* items, std::size_t count)
+        {
+            uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+            std::size_t claimed = 0;
+            for (;;)
+            {
+                claimed = CountReady(position, count, 0);
+                if (claimed == 0)
+                {
+                    const uint64_t current = enqueuePosition.load(std::memory_order_relaxed);
+                    if (current == position)
+                    {
+                        return 0;
+                    }
+                    position = current;
+                    continue;
+                }
+                if (enqueuePosition.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (std::size_t index = 0; index < claimed; ++index)
+            {
+                Slot& slot = slots[(position + index) & mask];
+                slot.value = std::move(items[index]);
+                slot.sequence.store(position + index + 1, std::memory_order_release);
+            }
+            return claimed;
+        }
+
+        /**
+         * @brief Removes the oldest item. Safe from any thread.
+         *
+         * @param item Receives the item on success.
+         * @return false if the queue is empty.
+         */
+        bool TryPop(T& item)
+        {
+            return PopBatch(&item, 1) == 1;
+        }
+
+        /**
+         * @brief Removes up to a number of the oldest consecutive items. Safe from any thread.
+         *
+         * @param items Receives the items in queue order.
+         * @param count The maximum number of items to be removed.
+         * @return std::size_t The number of items removed.
+         */
+        std::size_t PopBatch(T* items, std::size_t count)
+        {
+            uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+            std::size_t claimed = 0;
+            for (;;)
+            {
+                claimed = CountReady(position, count, 1);
+                if (claimed == 0)
+                {
+                    const uint64_t current = dequeuePosition.load(std::memory_order_relaxed);
+                    if (current == position)
+                    {
+                        return 0;
+                    }
+                    position = current;
+                    continue;
+                }
+                if (dequeuePosition.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            for (std::size_t index = 0; index < claimed; ++index)
+            {
+                Slot& slot = slots[(position + index) & mask];
+                items[index] = std::move(slot.value);
+                slot.sequence.store(position + index + mask + 1, std::memory_order_release);
+            }
+            return claimed;
+        }
+
+        /**
+         * @brief Gets the approximate number of queued items. Safe from any thread.
+         */
+        std::size_t Size() const
+        {
+            const uint64_t head = dequeuePosition.load(std::memory_order_acquire);
+            const uint64_t tail = enqueuePosition.load(std::memory_order_acquire);
+            return tail > head ? static_cast<std::size_t>(tail - head) : 0;
+        }
+
+        /**
+         * @brief Gets the maximum number of queued items.
+         */
+        std::size_t GetCapacity() const
+        {
+            return static_cast<std::size_t>(mask + 1);
+        }
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> sequence;
+            T value;
+        };
+
+        /**
+         * @brief Counts the consecutive slots from a position that are ready for the next lap.
+         *
+         * A slot at position p is free for a producer once its sequence is p, and filled for a
+         * consumer once it is p + 1.
+         */
+        std::size_t CountReady(uint64_t position, std::size_t count, uint64_t offset) const
+        {
+            std::size_t ready = 0;
+            while (ready < count && ready <= mask &&
+                   slots[(position + ready) & mask].sequence.load(std::memory_order_acquire) ==
+                       position + ready + offset)
+            {
+                ++ready;
+            }
+            return ready;
+        }
+
+        alignas(64) std::atomic<uint64_t> enqueuePosition;
+        alignas(64) std::atomic<uint64_t> dequeuePosition;
+        uint64_t mask;
+        std::unique_ptr<Slot[]> slots;
+    };
+} // namespace Concurrency
@@ -0,0 +1,368 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ITask.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#endif
+
+/**
+ * @brief The real-time scheduling policy applied on Linux to threads above normal priority,
+ * SCHED_FIFO or SCHED_RR.
+ */
+#if defined(__linux__) && !defined(CONCURRENCY_REALTIME_POLICY)
+#define CONCURRENCY_REALTIME_POLICY SCHED_FIFO
+#endif
+
+namespace Concurrency
+{
+    /**
+     * @brief The processor time a thread has consumed and how often it was switched out, since
+     * the thread started.
+     */
+    struct ThreadCpuUsage
+    {
+        /**
+         * @brief The user and kernel time in nanoseconds. On Windows the thread times advance by
+         * whole timer ticks, so use the cycles to compare short executions.
+         */
+        uint64_t cpuTime;
+
+        /**
+         * @brief The processor cycles on Windows, 0 elsewhere.
+         */
+        uint64_t cycles;
+
+        /**
+         * @brief The times the thread gave up the processor by blocking, on Linux; 0 elsewhere.
+         */
+        uint64_t voluntarySwitches;
+
+        /**
+         * @brief The times the thread was preempted, on Linux; 0 elsewhere.
+         */
+        uint64_t involuntarySwitches;
+    };
+
+    /**
+     * @brief Helpers operating on the calling OS thread.
+     *
+     * These are used by the header-only executors (ThreadPool, PooledScheduler) to give their
+     * std::thread workers the same priority and naming treatment that Thread applies to the
+     * threads it owns, and to pin them to processors.
+     *
+     * The Linux branches are provided for a future POSIX build of the library. The prebuilt
+     * library ships for Windows only, and the executors using these helpers need its
+     * ConcurrencyLog and RoutineTimeMonitor to link, so on Linux the helpers are only tested on
+     * their own, by NativeThreadTest, and not inside the executors.
+     */
+    namespace ThisThread
+    {
+#if defined(_WIN32)
+        /**
+         * @brief The number of logical processors per processor group in the numbering of
+         * SetAffinity(): the width of KAFFINITY, 64 in 64-bit processes and 32 in 32-bit ones.
+         */
+        constexpr uint32_t PROCESSOR_GROUP_WIDTH = sizeof(KAFFINITY) * CHAR_BIT;
+#endif
+
+        /**
+         * @brief Gets the operating system identifier of the calling thread, as shown by
+         * debuggers and `top -H`: the Win32 thread id on Windows, the kernel tid on Linux, and a
+         * hash of std::thread::id elsewhere.
+         *
+         * @return uint64_t The identifier of the calling thread.
+         */
+        inline uint64_t GetId()
+        {
+#if defined(_WIN32)
+            return ::GetCurrentThreadId();
+#elif defined(__linux__)
+            static thread_local const uint64_t id = static_cast<uint64_t>(::syscall(SYS_gettid));
+            return id;
+#else
+            return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+        }
+
+        /**
+         * @brief Applies a task priority to the calling thread.
+         *
+         * The value is a Win32 thread priority level (THREAD_PRIORITY_*), exactly as it is for
+         * Thread. On Linux, levels above normal select CONCURRENCY_REALTIME_POLICY with a
+         * real-time priority scaled from ABOVE_NORMAL up to TIME_CRITICAL (15) at the maximum,
+         * which needs CAP_SYS_NICE or a matching RLIMIT_RTPRIO; normal and lower levels keep
+         * SCHED_OTHER with a nice value of five per level below normal, capped at 19. Other
+         * platforms keep the default scheduling policy.
+         *
+         * @param priority The priority to apply.
+         * @return true if the priority was applied, false otherwise.
+         */
+        inline bool SetPriority(const TaskPriority priority)
+        {
+#if defined(_WIN32)
+            return ::SetThreadPriority(::GetCurrentThread(), static_cast<int>(priority)) != 0;
+#elif defined(__linux__)
+            const int level = static_cast<int>(priority);
+            sched_param param = {};
+            if (level > 0)
+            {
+                const int lowest = ::sched_get_priority_min(CONCURRENCY_REALTIME_POLICY);
+                const int highest = ::sched_get_priority_max(CONCURRENCY_REALTIME_POLICY);
+                const int scaled = lowest + (highest - lowest) * (level < 15 ? level : 15) / 15;
+                param.sched_priority = scaled;
+                return ::pthread_setschedparam(::pthread_self(), CONCURRENCY_REALTIME_POLICY, &param) == 0;
+            }
+            if (::pthread_setschedparam(::pthread_self(), SCHED_OTHER, &param) != 0)
+            {
+                return false;
+            }
+            // The nice value of a Linux thread applies to that thread alone.
+            const int nice = -level * 5 < 19 ? -level * 5 : 19;
+            return ::setpriority(PRIO_PROCESS, static_cast<id_t>(GetId()), nice) == 0;
+#else
+            (void)priority;
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Sets the name of the calling thread as shown by debuggers and profilers.
+         *
+         * @param name The thread name.
+         */
+        inline void SetName(const std::string& name)
+        {
+#if defined(_WIN32)
+            const std::wstring wideName(name.begin(), name.end());
+            ::SetThreadDescription(::GetCurrentThread(), wideName.c_str());
+#elif defined(__linux__)
+            // Linux names are limited to 15 characters; a longer name keeps its "-index" suffix.
+            static const std::size_t NAME_LENGTH = 15;
+            std::string shortName = name;
+            if (shortName.size() > NAME_LENGTH)
+            {
+                const std::size_t separator = name.rfind('-');
+                const std::size_t suffix =
+                    separator == std::string::npos || name.size() - separator >= NAME_LENGTH ? 0 : name.size() - separator;
+                shortName = name.substr(0, NAME_LENGTH - suffix) + name.substr(name.size() - suffix);
+            }
+            ::pthread_setname_np(::pthread_self(), shortName.c_str());
+#else
+            (void)name;
+#endif
+        }
+
+        /**
+         * @brief Hints the processor that the calling thread is busy-waiting.
+         *
+         * Emits a pause instruction where available, which lowers the power draw of a spin loop and
+         * frees execution resources for the sibling hyper-thread.
+         */
+        inline void CpuRelax()
+        {
+#if defined(_WIN32)
+            YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+
+        /**
+         * @brief Reads the processor time and context switches of the calling thread.
+         *
+         * Costs a system call or two, so it is meant for opt-in accounting rather than every
+         * execution of every job.
+         *
+         * @param usage Receives the usage of the calling thread.
+         * @return true if the usage was read, false if the platform is not supported.
+         */
+        inline bool GetCpuUsage(ThreadCpuUsage& usage)
+        {
+            usage = ThreadCpuUsage();
+#if defined(_WIN32)
+            FILETIME creation, exit, kernel, user;
+            if (!::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user))
+            {
+                return false;
+            }
+            const uint64_t ticks = ((static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime) +
+                                   ((static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime);
+            usage.cpuTime = ticks * 100;
+            ULONG64 cycles = 0;
+            if (::QueryThreadCycleTime(::GetCurrentThread(), &cycles))
+            {
+                usage.cycles = cycles;
+            }
+            return true;
+#elif defined(__linux__)
+            timespec time;
+            if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+            {
+                return false;
+            }
+            usage.cpuTime = static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+            rusage resources;
+            if (::getrusage(RUSAGE_THREAD, &resources) == 0)
+            {
+                usage.voluntarySwitches = static_cast<uint64_t>(resources.ru_nvcsw);
+                usage.involuntarySwitches = static_cast<uint64_t>(resources.ru_nivcsw);
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Restricts the calling thread to a set of logical processors.
+         *
+         * On Windows the processors are numbered across processor groups, PROCESSOR_GROUP_WIDTH per
+         * group, so a 32-bit process only reaches the first 32 processors of every group. All of
+         * them must belong to the group of the first one; the others are ignored.
+         *
+         * @param processors The indices of the logical processors the thread may run on.
+         * @return true if the affinity was applied, false otherwise.
+         */
+        inline bool SetAffinity(const std::vector<uint32_t>& processors)
+        {
+            if (processors.empty())
+            {
+                return false;
+            }
+#if defined(_WIN32)
+            GROUP_AFFINITY affinity = {};
+            affinity.Group = static_cast<WORD>(processors.front() / PROCESSOR_GROUP_WIDTH);
+            for (const uint32_t processor : processors)
+            {
+                if (processor / PROCESSOR_GROUP_WIDTH == affinity.Group)
+                {
+                    affinity.Mask |= static_cast<KAFFINITY>(1) << (processor % PROCESSOR_GROUP_WIDTH);
+                }
+            }
+            return ::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (const uint32_t processor : processors)
+            {
+                if (processor < CPU_SETSIZE)
+                {
+                    CPU_SET(processor, &set);
+                }
+            }
+            return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Parses a list of processors in the Linux cpulist format, such as "0-3,8,10-11".
+         *
+         * @param list The list, which may end with a line feed.
+         * @return std::vector<uint32_t> The processors in the order listed; the processors before
+         * the first malformed entry if the list is malformed.
+         */
+        inline std::vector<uint32_t> ParseProcessorList(const char* list)
+        {
+            std::vector<uint32_t> processors;
+            const char* cursor = list;
+            for (;;)
+            {
+                char* end = nullptr;
+                const unsigned long first = std::strtoul(cursor, &end, 10);
+                if (end == cursor)
+                {
+                    break;
+                }
+                unsigned long last = first;
+                cursor = end;
+                if (*cursor == '-')
+                {
+                    last = std::strtoul(cursor + 1, &end, 10);
+                    if (end == cursor + 1 || last < first)
+                    {
+                        break;
+                    }
+                    cursor = end;
+                }
+                for (unsigned long processor = first; processor <= last; ++processor)
+                {
+                    processors.push_back(static_cast<uint32_t>(processor));
+                }
+                if (*cursor != ',')
+                {
+                    break;
+                }
+                ++cursor;
+            }
+            return processors;
+        }
+
+        /**
+         * @brief Gets the logical processors of a NUMA node.
+         *
+         * @param node The index of the NUMA node.
+         * @return std::vector<uint32_t> The indices of the processors of the node, numbered as for
+         * SetAffinity(); empty if the node does not exist or the platform is not supported.
+         */
+        inline std::vector<uint32_t> GetNumaNodeProcessors(uint32_t node)
+        {
+            std::vector<uint32_t> processors;
+#if defined(_WIN32)
+            GROUP_AFFINITY affinity = {};
+            if (node <= 0xFFFF && ::GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity))
+            {
+                for (uint32_t bit = 0; bit < PROCESSOR_GROUP_WIDTH; ++bit)
+                {
+                    if ((affinity.Mask >> bit) & 1)
+                    {
+                        processors.push_back(static_cast<uint32_t>(affinity.Group) * PROCESSOR_GROUP_WIDTH + bit);
+                    }
+                }
+            }
+#elif defined(__linux__)
+            char path[64];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+            std::FILE* file = std::fopen(path, "r");
+            if (file == nullptr)
+            {
+                return processors;
+            }
+            std::string list;
+            char chunk[256];
+            std::size_t length = 0;
+            while ((length = std::fread(chunk, 1, sizeof(chunk), file)) != 0)
+            {
+                list.append(chunk, length);
+            }
+            std::fclose(file);
+            processors = ParseProcessorList(list.c_str());
+#else
+            (void)node;
+#endif
+            return processors;
+        }
+    } // namespace ThisThread
+} // namespace Concurrency
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "JobStats.hpp"
+#include "PooledScheduler.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief Writes the statistics of all jobs of a PooledScheduler in the OpenMetrics text format,
+     * which Prometheus scrapes as well.
+     *
+     * Every job is one series per metric, labelled with its name, so the names of the attached
+     * jobs should be unique. The counters are the runs, errors, duration overruns and interval
+     * faults of each job, the gauges its last, minimum and maximum duration and interval, and jobs
+     * recording latency histograms add a summary of the 50th, 99th and 99.9th percentiles of both.
+     * Jobs with CPU accounting add their processor time and context switches.
+     *
+     * The statistics are read through PooledScheduler::CollectStats(), so a scrape never pauses
+     * dispatch. The exporter keeps the rows of the last scrape and reuses them, so scraping the
+     * same jobs again does not allocate besides the output stream. An exporter must be used by one
+     * thread at a time.
+     */
+    class OpenMetricsExporter
+    {
+    public:
+        /**
+         * @brief Construct a new OpenMetrics Exporter object.
+         *
+         * @param prefix The prefix of every metric name, which must be a valid metric name itself.
+         */
+        explicit OpenMetricsExporter(const char* prefix = "concurrency_job")
+            : prefix(prefix == nullptr ? "" : prefix), rowCount(0)
+        {
+        }
+
+        /**
+         * @brief Writes the statistics of every attached job, terminated by the EOF marker.
+         *
+         * @param scheduler The scheduler whose jobs are exported.
+         * @param stream The stream the exposition is written to.
+         * @return std::size_t The number of jobs exported.
+         */
+        std::size_t Write(const PooledScheduler& scheduler, std::ostream& stream)
+        {
+            rowCount = 0;
+            scheduler.CollectStats([this](const JobStats& stats) { Add(stats); });
+
+            WriteFamily(stream, "_runs", "counter", nullptr, "Completed executions of the job.", "_total",
+                        [](const Row& row) { return row.timing.sampleCount; });
+            WriteFamily(stream, "_errors", "counter", nullptr, "Executions of the job that threw.", "_total",
+                        [](const Row& row) { return static_cast<uint64_t>(row.errorCount); });
+            WriteFamily(stream, "_duration_overruns", "counter", nullptr,
+                        "Executions of the job that took longer than their expected duration.", "_total",
+                        [](const Row& row) { return row.timing.elapsedFaultCount; });
+            WriteFamily(stream, "_interval_faults", "counter", nullptr,
+                        "Executions of the job that came late or were skipped.", "_total",
+                        [](const Row& row) { return row.timing.intervalFaultCount; });
+            WriteFamily(stream, "_interval_expected_microseconds", "gauge", "microseconds",
+                        "The configured interval of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.interval); });
+            WriteFamily(stream, "_duration_last_microseconds", "gauge", "microseconds",
+                        "The duration of the last execution of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.currentDuration); });
+            WriteFamily(stream, "_duration_min_microseconds", "gauge", "microseconds",
+                        "The shortest execution of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.minDuration); });
+            WriteFamily(stream, "_duration_max_microseconds", "gauge", "microseconds",
+                        "The longest execution of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.maxDuration); });
+            WriteFamily(stream, "_interval_last_microseconds", "gauge", "microseconds",
+                        "The time between the last two executions of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.currentInterval); });
+            WriteFamily(stream, "_interval_min_microseconds", "gauge", "microseconds",
+                        "The shortest time between two executions of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.minInterval); });
+            WriteFamily(stream, "_interval_max_microseconds", "gauge", "microseconds",
+                        "The longest time between two executions of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.maxInterval); });
+            WriteSummary(stream, "_duration_microseconds", "The distribution of the execution durations of the job.",
+                         &Row::duration);
+            WriteSummary(stream, "_interval_microseconds",
+                         "The distribution of the times between executions of the job.", &Row::period);
+            WriteFamily(stream, "_cpu_time_microseconds", "counter", "microseconds",
+                        "The processor time consumed by the executions of the job.", "_total",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.totalCpuTime); }, true);
+            WriteFamily(stream, "_cpu_last_microseconds", "gauge", "microseconds",
+                        "The processor time of the last execution of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.currentCpuTime); }, true);
+            WriteFamily(stream, "_cpu_max_microseconds", "gauge", "microseconds",
+                        "The largest processor time of an execution of the job.", "",
+                        [](const Row& row) { return static_cast<uint64_t>(row.timing.maxCpuTime); }, true);
+            WriteFamily(stream, "_voluntary_switches", "counter", nullptr,
+                        "Times the executions of the job blocked and gave up the processor.", "_total",
+                        [](const Row& row) { return row.timing.voluntarySwitches; }, true);
+            WriteFamily(stream, "_involuntary_switches", "counter", nullptr,
+                        "Times the executions of the job were preempted.", "_total",
+                        [](const Row& row) { return row.timing.involuntarySwitches; }, true);
+            stream << "# EOF\n";
+            return rowCount;
+        }
+
+    private:
+        /**
+         * @brief The percentiles of one latency histogram, copied while its job was visited.
+         */
+        struct Distribution
+        {
+            uint64_t count;
+            uint64_t quantiles[3];
+        };
+
+        struct Row
+        {
+            std::string label;
+            Microsecond interval;
+            uint32_t errorCount;
+            RoutineTimeSnapshot timing;
+            bool hasHistograms;
+            bool cpuAccounting;
+            Distribution duration;
+            Distribution period;
+        };
+
+        static constexpr double QUANTILES[3] = {0.5, 0.99, 0.999};
+
+        void Add(const JobStats& stats)
+        {
+            if (rowCount == rows.size())
+            {
+                rows.emplace_back();
+            }
+            Row& row = rows[rowCount++];
+            row.label.clear();
+            AppendEscaped(row.label, stats.name == nullptr ? "" : stats.name);
+            row.interval = stats.interval;
+            row.errorCount = stats.errorCount;
+            row.timing = stats.timing;
+            row.hasHistograms = stats.durationHistogram != nullptr && stats.intervalHistogram != nullptr;
+            row.cpuAccounting = stats.cpuAccounting;
+            if (row.hasHistograms)
+            {
+                Summarize(*stats.durationHistogram, row.duration);
+                Summarize(*stats.intervalHistogram, row.period);
+            }
+        }
+
+        static void Summarize(const RoutineLatencyHistogram& histogram, Distribution& distribution)
+        {
+            distribution.count = histogram.GetTotalCount();
+            for (std::size_t index = 0; index < 3; ++index)
+            {
+                distribution.quantiles[index] = histogram.GetValueAtPercentile(QUANTILES[index] * 100.0);
+            }
+        }
+
+        /**
+         * @brief Escapes a label value: backslashes, double quotes and line feeds.
+         */
+        static void AppendEscaped(std::string& target, const char* text)
+        {
+            for (; *text != '\0'; ++text)
+            {
+                if (*text == '\\' || *text == '"')
+                {
+                    target += '\\';
+                    target += *text;
+                }
+                else if (*text == '\n')
+                {
+                    target += "\\n";
+                }
+                else
+                {
+                    target += *text;
+                }
+            }
+        }
+
+        void WriteHeader(std::ostream& stream, const char* suffix, const char* type, const char* unit,
+                         const char* help) const
+        {
+            stream << "# TYPE " << prefix << suffix << ' ' << type << '\n';
+            if (unit != nullptr)
+            {
+                stream << "# UNIT " << prefix << suffix << ' ' << unit << '\n';
+            }
+            stream << "# HELP " << prefix << suffix << ' ' << help << '\n';
+        }
+
+        template <typename Value>
+        void WriteFamily(std::ostream& stream, const char* suffix, const char* type, const char* unit,
+                         const char* help, const char* sampleSuffix, Value value, bool cpuOnly = false) const
+        {
+            WriteHeader(stream, suffix, type, unit, help);
+            for (std::size_t index = 0; index < rowCount; ++index)
+            {
+                const Row& row = rows[index];
+                if (cpuOnly && !row.cpuAccounting)
+                {
+                    continue;
+                }
+                stream << prefix << suffix << sampleSuffix << "{job=\"" << row.label << "\"} " << value(row) << '\n';
+            }
+        }
+
+        void WriteSummary(std::ostream& stream, const char* suffix, const char* help,
+                          Distribution Row::*distribution) const
+        {
+            WriteHeader(stream, suffix, "summary", "microseconds", help);
+            for (std::size_t index = 0; index < rowCount; ++index)
+            {
+                const Row& row = rows[index];
+                if (!row.hasHistograms)
+                {
+                    continue;
+                }
+                const Distribution& values = row.*distribution;
+                for (std::size_t quantile = 0; quantile < 3; ++quantile)
+                {
+                    stream << prefix << suffix << "{job=\"" << row.label << "\",quantile=\"" << QUANTILES[quantile]
+                           << "\"} " << values.quantiles[quantile] << '\n';
+                }
+                stream << prefix << suffix << "_count{job=\"" << row.label << "\"} " << values.count << '\n';
+            }
+        }
+
+        const std::string prefix;
+        std::vector<Row> rows;
+        std::size_t rowCount;
+    };
+} // namespace Concurrency
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief The shared state of one ParallelFor or ParallelReduce call.
+     *
+     * The range is cut into chunks of the grain size, which the calling thread and the helpers it
+     * enlisted on the pool claim one at a time through a shared counter, so a thread finishing its
+     * chunks early simply claims more. The calling thread takes part until every chunk has been
+     * claimed and then waits only for the chunks still running on helpers; it never executes
+     * unrelated pool tasks. Helpers hold the state, so one that starts after the call has
+     * returned finds no chunk left and leaves without touching the caller.
+     */
+    class ParallelLoop
+    {
+    public:
+        typedef void (*Body)(void* context, std::size_t chunk, std::size_t first, std::size_t last);
+
+        ParallelLoop(std::size_t begin, std::size_t end, std::size_t grain, Body body, void* context)
+            : begin(begin),
+              end(end),
+              grain(grain),
+              chunkCount((end - begin + grain - 1) / grain),
+              body(body),
+              context(context),
+              next(0),
+              completed(0),
+              failed(false)
+        {
+        }
+
+        /**
+         * @brief Gets the number of chunks the range is cut into.
+         */
+        std::size_t GetChunkCount() const
+        {
+            return chunkCount;
+        }
+
+        /**
+         * @brief Gets the grain used when none is given: about four chunks per pool thread.
+         *
+         * @param count The number of elements in the range.
+         * @param threadCount The number of threads taking part.
+         */
+        static std::size_t DefaultGrain(std::size_t count, std::size_t threadCount)
+        {
+            return std::max<std::size_t>(1, count / (threadCount * 4));
+        }
+
+        /**
+         * @brief Runs the loop on a pool, the calling thread included.
+         *
+         * @param loop The state of the loop.
+         * @param pool The pool of the helpers, nullptr to run every chunk on the calling thread.
+         */
+        static void Run(const std::shared_ptr<ParallelLoop>& loop, ThreadPool* pool)
+        {
+            if (pool != nullptr)
+            {
+                const std::size_t threads = pool->GetThreadCount() - (pool->IsWorkerThread() ? 1 : 0);
+                const std::size_t helpers = (std::min)(threads, loop->chunkCount - 1);
+                for (std::size_t index = 0; index < helpers; ++index)
+                {
+                    pool->Submit([loop]() { loop->RunChunks(); });
+                }
+            }
+            loop->RunChunks();
+            loop->Wait();
+        }
+
+    private:
+        void RunChunks()
+        {
+            for (;;)
+            {
+                const std::size_t chunk = next.fetch_add(1);
+                if (chunk >= chunkCount)
+                {
+                    return;
+                }
+                if (!failed.load(std::memory_order_relaxed))
+                {
+                    const std::size_t first = begin + chunk * grain;
+                    try
+                    {
+                        body(context, chunk, first, (std::min)(first + grain, end));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!failure)
+                        {
+                            failure = std::current_exception();
+                        }
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+                if (completed.fetch_add(1) + 1 == chunkCount)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cond.notify_all();
+                }
+            }
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this]() { return completed.load() == chunkCount; });
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        const std::size_t begin;
+        const std::size_t end;
+        const std::size_t grain;
+        const std::size_t chunkCount;
+        const Body body;
+        void* const context;
+        std::atomic<std::size_t> next;
+        std::atomic<std::size_t> completed;
+        std::atomic<bool> failed;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::exception_ptr failure;
+    };
+
+    /**
+     * @brief Calls a function for every index of a range, spread over the threads of a pool.
+     *
+     * Called from a job inside RunOnce(), the job's own thread works through the range along with
+     * the other pool threads. The function must be safe to call concurrently for different
+     * indices. If it throws, the chunks not started yet are skipped and the first exception is
+     * rethrown once the running chunks have completed.
+     *
+     * @param pool The pool to spread the range over, nullptr to run it on the calling thread.
+     * @param begin The first index of the range.
+     * @param end The index past the last one of the range.
+     * @param grain The number of consecutive indices handed out at once, 0 for about four chunks
+     * per pool thread. Small grains balance uneven work, large ones save claiming overhead.
+     * @param function The function called with every index.
+     */
+    template <typename Function>
+    void ParallelFor(ThreadPool* pool, std::size_t begin, std::size_t end, std::size_t grain, Function function)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        if (grain == 0)
+        {
+            grain = ParallelLoop::DefaultGrain(end - begin, pool == nullptr ? 1 : pool->GetThreadCount());
+        }
+        const ParallelLoop::Body body = [](void* context, std::size_t, std::size_t first, std::size_t last) {
+            Function& function = *static_cast<Function*>(context);
+            for (std::size_t index = first; index < last; ++index)
+            {
+                function(index);
+            }
+        };
+        ParallelLoop::Run(std::make_shared<ParallelLoop>(begin, end, grain, body, &function), pool);
+    }
+
+    /**
+     * @brief Calls a function for every index of a range, spread over the pool of the calling thread.
+     *
+     * Outside of a pool thread the range runs on the calling thread. See
+     * ParallelFor(ThreadPool*, std::size_t, std::size_t, std::size_t, Function).
+     */
+    template <typename Function>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Function function)
+    {
+        ParallelFor(ThreadPool::GetCurrent(), begin, end, grain, std::move(function));
+    }
+
+    /**
+     * @brief Maps every index of a range to a value and combines the values, spread over the
+     * threads of a pool.
+     *
+     * Every chunk folds its indices from the identity, then the results of the chunks are combined
+     * on the calling thread in the order of the range, so the result does not depend on which
+     * thread ran which chunk, even for floating-point values. The result of every chunk has a cache
+     * line of its own, so chunks finishing at the same time do not contend, also for T = bool.
+     *
+     * @param pool The pool to spread the range over, nullptr to run it on the calling thread.
+     * @param begin The first index of the range.
+     * @param end The index past the last one of the range.
+     * @param grain The number of consecutive indices handed out at once, 0 for about four chunks
+     * per pool thread.
+     * @param identity The value combining leaves any other value unchanged.
+     * @param transform The function mapping an index to a value.
+     * @param combine The associative function combining two values.
+     * @return T The combination of the values of all indices, the identity for an empty range.
+     */
+    template <typename T, typename Transform, typename Combine>
+    T ParallelReduce(ThreadPool* pool, std::size_t begin, std::size_t end, std::size_t grain, T identity,
+                     Transform transform, Combine combine)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+        if (grain == 0)
+        {
+            grain = ParallelLoop::DefaultGrain(end - begin, pool == nullptr ? 1 : pool->GetThreadCount());
+        }
+        struct alignas(64) alignas(T) Partial
+        {
+            T value;
+        };
+        struct Reduction
+        {
+            const T& identity;
+            Transform& transform;
+            Combine& combine;
+            std::vector<Partial> partials;
+        } reduction{identity, transform, combine, std::vector<Partial>()};
+        const ParallelLoop::Body body = [](void* context, std::size_t chunk, std::size_t first, std::size_t last) {
+            Reduction& reduction = *static_cast<Reduction*>(context);
+            T value = reduction.identity;
+            for (std::size_t index = first; index < last; ++index)
+            {
+                value = reduction.combine(std::move(value), reduction.transform(index));
+            }
+            reduction.partials[chunk].value = std::move(value);
+        };
+        const std::shared_ptr<ParallelLoop> loop = std::make_shared<ParallelLoop>(begin, end, grain, body, &reduction);
+        reduction.partials.assign(loop->GetChunkCount(), Partial{identity});
+        ParallelLoop::Run(loop, pool);
+        T result = std::move(identity);
+        for (std::size_t chunk = 0; chunk < reduction.partials.size(); ++chunk)
+        {
+            result = combine(std::move(result), std::move(reduction.partials[chunk].value));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Maps every index of a range to a value and combines the values, spread over the pool
+     * of the calling thread.
+     *
+     * Outside of a pool thread the range runs on the calling thread. See
+     * ParallelReduce(ThreadPool*, std::size_t, std::size_t, std::size_t, T, Transform, Combine).
+     */
+    template <typename T, typename Transform, typename Combine>
+    T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, Transform transform,
+                     Combine combine)
+    {
+        return ParallelReduce(ThreadPool::GetCurrent(), begin, end, grain, std::move(identity), std::move(transform),
+                              std::move(combine));
+    }
+} // namespace Concurrency
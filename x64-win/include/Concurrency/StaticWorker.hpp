@@ -0,0 +1,71 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace Concurrency
+{
+    /**
+     * @brief A scheduled worker whose action is bound at compile time, for BasicScheduler.
+     *
+     * Unlike an IScheduledWorker or an Action, the callable is stored by value and RunOnce() is
+     * neither virtual nor type-erased, so a scheduler knowing the type of the worker can inline
+     * the whole action into its dispatch loop. A StaticWorker is not an IScheduledWorker and
+     * cannot be attached to the schedulers taking one; wrap the callable into an Action instead.
+     *
+     * @tparam F The callable type, invoked without arguments.
+     */
+    template <typename F>
+    class StaticWorker
+    {
+    public:
+        /**
+         * @brief Construct a new Static Worker object.
+         *
+         * @param name The name of the worker, which must outlive it.
+         * @param action The action to be executed by the worker.
+         */
+        StaticWorker(const char* name, F action) : name(name), action(std::move(action))
+        {
+        }
+
+        /**
+         * @brief Runs the action once.
+         */
+        void RunOnce()
+        {
+            action();
+        }
+
+        /**
+         * @brief Gets the name of the worker.
+         */
+        const char* GetWorkerName() const
+        {
+            return name;
+        }
+
+        /**
+         * @brief Does nothing: a static worker has no timeout callback.
+         */
+        void NotifyDurationTimeout(const bool&) const
+        {
+        }
+
+    private:
+        const char* const name;
+        F action;
+    };
+
+    /**
+     * @brief Makes a StaticWorker, deducing the type of the callable.
+     *
+     * @param name The name of the worker, which must outlive it.
+     * @param action The action to be executed by the worker.
+     */
+    template <typename F>
+    StaticWorker<typename std::decay<F>::type> MakeStaticWorker(const char* name, F&& action)
+    {
+        return StaticWorker<typename std::decay<F>::type>(name, std::forward<F>(action));
+    }
+} // namespace Concurrency
@@ -0,0 +1,311 @@
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CONCURRENCY_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifndef CONCURRENCY_HAS_COROUTINES
+#define CONCURRENCY_HAS_COROUTINES 0
+#endif
+
+#if CONCURRENCY_HAS_COROUTINES
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace Concurrency
+{
+    template <typename T>
+    class Task;
+
+    /**
+     * @brief The state shared by the promises of all Task types.
+     */
+    class TaskPromiseBase
+    {
+    public:
+        typedef void (*Completion)(void* context);
+
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                TaskPromiseBase& promise = handle.promise();
+                if (promise.continuation)
+                {
+                    return promise.continuation;
+                }
+                if (promise.completion != nullptr)
+                {
+                    promise.completion(promise.context);
+                }
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+
+    protected:
+        template <typename T>
+        friend class Task;
+
+        void Rethrow() const
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        std::coroutine_handle<> continuation;
+        Completion completion = nullptr;
+        void* context = nullptr;
+        std::exception_ptr exception;
+    };
+
+    /**
+     * @brief The promise of a Task producing a value.
+     */
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U&& result)
+        {
+            value.emplace(std::forward<U>(result));
+        }
+
+        T Result()
+        {
+            Rethrow();
+            return std::move(*value);
+        }
+
+    private:
+        std::optional<T> value;
+    };
+
+    /**
+     * @brief The promise of a Task producing no value.
+     */
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept
+        {
+        }
+
+        void Result() const
+        {
+            Rethrow();
+        }
+    };
+
+    /**
+     * @brief A lazily started coroutine producing a value of type T.
+     *
+     * The coroutine body does not run until the task is awaited or started with Start(). Awaiting
+     * a task from another coroutine resumes the awaiting coroutine on the thread that completes the
+     * task, without going through a scheduler. The task owns the coroutine frame and destroys it
+     * when it is itself destroyed, which must not happen while the coroutine is running.
+     *
+     * Only available when the compiler supports C++20 coroutines, see CONCURRENCY_HAS_COROUTINES.
+     *
+     * @tparam T The type of the value produced by the coroutine.
+     */
+    template <typename T = void>
+    class Task
+    {
+    public:
+        typedef TaskPromise<T> promise_type;
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        Task() noexcept = default;
+
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr))
+        {
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            Reset();
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        /**
+         * @brief Checks whether the task holds a coroutine.
+         */
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(handle);
+        }
+
+        /**
+         * @brief Checks whether the coroutine has completed.
+         */
+        bool IsDone() const noexcept
+        {
+            return !handle || handle.done();
+        }
+
+        /**
+         * @brief Starts the coroutine without awaiting it.
+         *
+         * The completion is called on the thread that completes the coroutine, possibly before
+         * Start() returns. It may destroy the task.
+         *
+         * @param completion The function called once the coroutine has completed.
+         * @param context The argument passed to the completion.
+         */
+        void Start(TaskPromiseBase::Completion completion, void* context)
+        {
+            handle.promise().completion = completion;
+            handle.promise().context = context;
+            handle.resume();
+        }
+
+        /**
+         * @brief Gets the value produced by the completed coroutine, rethrowing its exception if it failed.
+         */
+        T GetResult()
+        {
+            return handle.promise().Result();
+        }
+
+        /**
+         * @brief Awaits the task from another coroutine.
+         */
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                Handle handle;
+
+                bool await_ready() const noexcept
+                {
+                    return !handle || handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume()
+                {
+                    return handle.promise().Result();
+                }
+            };
+            return Awaiter{handle};
+        }
+
+    private:
+        friend class TaskPromise<T>;
+
+        explicit Task(Handle handle) noexcept : handle(handle)
+        {
+        }
+
+        void Reset() noexcept
+        {
+            if (handle)
+            {
+                handle.destroy();
+                handle = nullptr;
+            }
+        }
+
+        Handle handle;
+    };
+
+    template <typename T>
+    inline Task<T> TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(Task<T>::Handle::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(Task<void>::Handle::from_promise(*this));
+    }
+
+    /**
+     * @brief Runs a task to completion, blocking the calling thread while it is suspended.
+     *
+     * @param task The task to be run.
+     * @return T The value produced by the task.
+     */
+    template <typename T>
+    T SyncWait(Task<T> task)
+    {
+        struct Waiter
+        {
+            std::mutex mutex;
+            std::condition_variable cond;
+            bool done = false;
+
+            static void Complete(void* context)
+            {
+                Waiter& waiter = *static_cast<Waiter*>(context);
+                std::lock_guard<std::mutex> lock(waiter.mutex);
+                waiter.done = true;
+                waiter.cond.notify_one();
+            }
+        } waiter;
+
+        task.Start(&Waiter::Complete, &waiter);
+        std::unique_lock<std::mutex> lock(waiter.mutex);
+        waiter.cond.wait(lock, [&waiter]() { return waiter.done; });
+        return task.GetResult();
+    }
+} // namespace Concurrency
+
+#endif
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "IScheduler.hpp"
+#include "LogFilter.hpp"
+#include "ThreadPool.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A scheduled worker running a directed acyclic graph of actions once per execution.
+     *
+     * Stages of a pipeline attached as separate workers run on staggered intervals, so each one
+     * reads what the previous one produced up to a whole interval earlier. Attached as a single
+     * worker, a graph runs every stage of one tick right after its predecessors have completed,
+     * and independent stages in parallel, and the time monitor of the job measures the whole
+     * graph from its first action to its last.
+     *
+     * The thread executing RunOnce() runs the actions itself and enlists helpers on the
+     * ThreadPool it is a worker of, or on the pool given to the constructor, for the actions
+     * that become ready at the same time. It only ever runs actions of this graph while it
+     * waits, so a graph also completes on a pool of a single thread and never runs into other
+     * jobs. Outside of a pool the actions run one after the other on the calling thread.
+     *
+     * If an action throws, the actions not started yet are skipped, and RunOnce() rethrows the
+     * first exception once the running ones have completed. The graph must be built before it is
+     * attached, and must outlive the pools it ran on or wait for them to stop.
+     */
+    class TaskGraph : public IScheduledWorker
+    {
+    public:
+        typedef std::size_t Node;
+
+        /**
+         * @brief Construct an empty graph.
+         *
+         * @param name The name of the graph as a scheduled worker.
+         * @param pool The pool running the parallel actions, nullptr for the pool of the thread
+         * executing the graph.
+         * @param callback The callback to be called with the timeout state after every execution.
+         */
+        explicit TaskGraph(const char* name, ThreadPool* pool = nullptr, TimeoutCallback callback = TimeoutCallback());
+        ~TaskGraph() override;
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        /**
+         * @brief Adds an action to the graph.
+         *
+         * @param action The action to be run once per execution of the graph.
+         * @return Node The node of the action, to declare its dependencies with.
+         */
+        Node Add(Action action);
+
+        /**
+         * @brief Declares that an action only runs after another one has completed.
+         *
+         * @param before The node that must complete first.
+         * @param after The node that waits for it.
+         * @return false if one of the nodes does not exist or the dependency would close a cycle,
+         * in which case it is not added.
+         */
+        bool Precede(Node before, Node after);
+
+        /**
+         * @brief Gets the number of actions in the graph.
+         */
+        std::size_t GetNodeCount() const;
+
+        /**
+         * @brief Runs every action of the graph once, respecting the dependencies.
+         */
+        void RunOnce() override;
+
+        const char* GetWorkerName() const override;
+        void NotifyDurationTimeout(const bool& isTimeout) const override;
+
+    private:
+        struct TaskNode
+        {
+            Action action;
+            std::vector<Node> successors;
+            uint32_t predecessors;
+            uint32_t pending;
+        };
+
+        /**
+         * @brief A task draining the ready actions on a pool thread.
+         */
+        class Helper : public ITask
+        {
+        public:
+            explicit Helper(TaskGraph& graph) : graph(graph), queued(false)
+            {
+            }
+
+            bool Run() override;
+
+            TaskGraph& graph;
+            std::atomic<bool> queued;
+        };
+
+        bool Reaches(Node from, Node to) const;
+        void Drain(std::unique_lock<std::mutex>& lock, bool waitForAll);
+        void Enlist();
+        void Execute(Node node);
+
+        const std::string name;
+        ThreadPool* const fixedPool;
+        const TimeoutCallback callback;
+        std::vector<TaskNode> nodes;
+        std::vector<std::unique_ptr<Helper>> helpers;
+        std::atomic<uint32_t> helpersInFlight;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        ThreadPool* pool;
+        std::vector<Node> ready;
+        std::size_t remaining;
+        std::exception_ptr failure;
+    };
+
+    inline TaskGraph::TaskGraph(const char* name, ThreadPool* pool, TimeoutCallback callback)
+        : name(name == nullptr ? "" : name),
+          fixedPool(pool),
+          callback(std::move(callback)),
+          helpersInFlight(0),
+          pool(nullptr),
+          remaining(0)
+    {
+    }
+
+    inline TaskGraph::~TaskGraph()
+    {
+        while (helpersInFlight.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    inline TaskGraph::Node TaskGraph::Add(Action action)
+    {
+        nodes.push_back(TaskNode{std::move(action), std::vector<Node>(), 0, 0});
+        return nodes.size() - 1;
+    }
+
+    inline bool TaskGraph::Precede(Node before, Node after)
+    {
+        if (before >= nodes.size() || after >= nodes.size() || Reaches(after, before))
+        {
+            LogFilter::Format<LogLevel::Warning>("graph %s rejected dependency %zu -> %zu", name.c_str(), before,
+                                                 after);
+            return false;
+        }
+        nodes[before].successors.push_back(after);
+        ++nodes[after].predecessors;
+        return true;
+    }
+
+    inline std::size_t TaskGraph::GetNodeCount() const
+    {
+        return nodes.size();
+    }
+
+    inline void TaskGraph::RunOnce()
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        pool = fixedPool != nullptr ? fixedPool : ThreadPool::GetCurrent();
+        if (pool != nullptr)
+        {
+            while (helpers.size() < pool->GetThreadCount() && helpers.size() < nodes.size())
+            {
+                helpers.emplace_back(new Helper(*this));
+            }
+        }
+        ready.reserve(nodes.size());
+        for (std::size_t index = 0; index < nodes.size(); ++index)
+        {
+            nodes[index].pending = nodes[index].predecessors;
+            if (nodes[index].pending == 0)
+            {
+                ready.push_back(index);
+            }
+        }
+        remaining = nodes.size();
+        failure = nullptr;
+        Drain(lock, true);
+        std::exception_ptr failed = std::move(failure);
+        failure = nullptr;
+        lock.unlock();
+        if (failed)
+        {
+            std::rethrow_exception(failed);
+        }
+    }
+
+    inline const char* TaskGraph::GetWorkerName() const
+    {
+        return name.c_str();
+    }
+
+    inline void TaskGraph::NotifyDurationTimeout(const bool& isTimeout) const
+    {
+        if (callback)
+        {
+            callback(isTimeout);
+        }
+    }
+
+    inline bool TaskGraph::Helper::Run()
+    {
+        queued.store(false);
+        {
+            std::unique_lock<std::mutex> lock(graph.mutex);
+            graph.Drain(lock, false);
+        }
+        graph.helpersInFlight.fetch_sub(1);
+        return false;
+    }
+
+    inline bool TaskGraph::Reaches(Node from, Node to) const
+    {
+        std::vector<Node> stack(1, from);
+        std::vector<bool> visited(nodes.size(), false);
+        while (!stack.empty())
+        {
+            const Node node = stack.back();
+            stack.pop_back();
+            if (node == to)
+            {
+                return true;
+            }
+            if (visited[node])
+            {
+                continue;
+            }
+            visited[node] = true;
+            stack.insert(stack.end(), nodes[node].successors.begin(), nodes[node].successors.end());
+        }
+        return false;
+    }
+
+    inline void TaskGraph::Drain(std::unique_lock<std::mutex>& lock, bool waitForAll)
+    {
+        for (;;)
+        {
+            if (!ready.empty())
+            {
+                const Node node = ready.back();
+                ready.pop_back();
+                Enlist();
+                const bool skipped = static_cast<bool>(failure);
+                lock.unlock();
+                if (!skipped)
+                {
+                    Execute(node);
+                }
+                lock.lock();
+                for (const Node successor : nodes[node].successors)
+                {
+                    if (--nodes[successor].pending == 0)
+                    {
+                        ready.push_back(successor);
+                    }
+                }
+                if (--remaining == 0 || !ready.empty())
+                {
+                    cond.notify_all();
+                }
+                continue;
+            }
+            if (!waitForAll || remaining == 0)
+            {
+                return;
+            }
+            cond.wait(lock);
+        }
+    }
+
+    inline void TaskGraph::Enlist()
+    {
+        // One helper per action that is ready beyond the one the calling thread takes. The helpers
+        // of an earlier execution on a pool stay around, but outside of a pool there is no one to
+        // hand them to.
+        if (pool == nullptr)
+        {
+            return;
+        }
+        std::size_t wanted = ready.size();
+        for (std::size_t index = 0; wanted != 0 && index < helpers.size(); ++index)
+        {
+            Helper& helper = *helpers[index];
+            if (!helper.queued.exchange(true))
+            {
+                helpersInFlight.fetch_add(1);
+                pool->Submit(helper);
+                --wanted;
+            }
+        }
+    }
+
+    inline void TaskGraph::Execute(Node node)
+    {
+        try
+        {
+            nodes[node].action();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+        }
+    }
+} // namespace Concurrency
@@ -0,0 +1,547 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "IScheduler.hpp"
+#include "IdleStrategy.hpp"
+#include "LogFilter.hpp"
+#include "NativeThread.hpp"
+#include "WorkStealingDeque.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A fixed-size, work-stealing pool of worker threads executing submitted actions.
+     *
+     * Every worker owns a WorkStealingDeque. Actions submitted from a worker thread of the pool
+     * are pushed to that worker's own deque, so fan-out sub-tasks stay on the core that spawned
+     * them. Actions submitted from any other thread go to a shared injection queue. A worker
+     * without local work drains the injection queue and then steals from the other workers
+     * before it waits as set by its IdleStrategy. Stopping the pool drains the actions that were
+     * already submitted before the workers are joined.
+     *
+     * Tasks travel through the queues as ITask pointers, so submitting an ITask never allocates.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Construct a new Thread Pool object.
+         *
+         * @param threadCount The number of worker threads, 0 selects DefaultThreadCount().
+         * @param threadPriority The priority applied to every worker thread.
+         * @param name The name prefix given to the worker threads.
+         * @param affinity The logical processors every worker thread is pinned to, empty for no pinning.
+         */
+        explicit ThreadPool(uint32_t threadCount = 0, TaskPriority threadPriority = 0, const char* name = "Pool",
+                            std::vector<uint32_t> affinity = std::vector<uint32_t>());
+
+        /**
+         * @brief Destroy the Thread Pool object, stopping it if it is still running.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Starts the worker threads. Does nothing if the pool is already running.
+         */
+        void Start();
+
+        /**
+         * @brief Executes the pending actions and joins the worker threads.
+         */
+        void Stop();
+
+        /**
+         * @brief Queues an action for execution on one of the worker threads.
+         *
+         * Called from a worker thread of this pool, the action is pushed to the caller's own
+         * deque; otherwise it is pushed to the injection queue.
+         *
+         * @param task The action to be executed.
+         */
+        void Submit(Action task);
+
+        /**
+         * @brief Queues a task for execution on one of the worker threads.
+         *
+         * The task is submitted again every time its Run() returns true, the same way a Thread
+         * keeps driving its ITask. The task must outlive its last execution, and must not be
+         * submitted again while it is still queued.
+         *
+         * @param task The task to be executed.
+         */
+        void Submit(ITask& task);
+
+        /**
+         * @brief Gets the number of worker threads of the pool.
+         *
+         * @return uint32_t The number of worker threads.
+         */
+        uint32_t GetThreadCount() const;
+
+        /**
+         * @brief Gets the logical processors the worker threads are pinned to.
+         *
+         * @return const std::vector<uint32_t>& The processors, empty if the threads are not pinned.
+         */
+        const std::vector<uint32_t>& GetAffinity() const;
+
+        /**
+         * @brief Sets how idle worker threads wait for new tasks. Takes effect the next time a
+         * thread runs out of work, the default is to park at once.
+         *
+         * @param strategy The idle strategy of the worker threads.
+         */
+        void SetIdleStrategy(const IdleStrategy& strategy);
+
+        /**
+         * @brief Gets how idle worker threads wait for new tasks.
+         */
+        IdleStrategy GetIdleStrategy() const;
+
+        /**
+         * @brief Checks whether the calling thread is a worker thread of this pool.
+         *
+         * @return true if called from one of the pool's worker threads.
+         */
+        bool IsWorkerThread() const;
+
+        /**
+         * @brief Gets the pool the calling thread is a worker thread of.
+         *
+         * @return ThreadPool* The pool, nullptr if the calling thread is not a pool thread.
+         */
+        static ThreadPool* GetCurrent();
+
+        /**
+         * @brief Gets the default pool size, which is the number of hardware threads.
+         *
+         * @return uint32_t The default number of worker threads, at least 1.
+         */
+        static uint32_t DefaultThreadCount();
+
+    private:
+        /**
+         * @brief Owns a submitted action and releases itself after running it.
+         */
+        class ActionTask : public ITask
+        {
+        public:
+            explicit ActionTask(Action action) : action(std::move(action))
+            {
+            }
+
+            bool Run() override
+            {
+                const std::unique_ptr<ActionTask> self(this);
+                action();
+                return false;
+            }
+
+        private:
+            Action action;
+        };
+
+        /**
+         * @brief A growable ring buffer holding the tasks submitted from outside the pool.
+         */
+        class InjectionQueue
+        {
+        public:
+            InjectionQueue() : head(0), count(0)
+            {
+            }
+
+            void Push(ITask* task)
+            {
+                if (count == slots.size())
+                {
+                    std::vector<ITask*> grown(slots.empty() ? 64 : slots.size() * 2, nullptr);
+                    for (std::size_t index = 0; index < count; ++index)
+                    {
+                        grown[index] = slots[(head + index) % slots.size()];
+                    }
+                    slots.swap(grown);
+                    head = 0;
+                }
+                slots[(head + count) % slots.size()] = task;
+                ++count;
+            }
+
+            ITask* Pop()
+            {
+                if (count == 0)
+                {
+                    return nullptr;
+                }
+                ITask* task = slots[head];
+                head = (head + 1) % slots.size();
+                --count;
+                return task;
+            }
+
+            bool Empty() const
+            {
+                return count == 0;
+            }
+
+        private:
+            std::vector<ITask*> slots;
+            std::size_t head;
+            std::size_t count;
+        };
+
+        typedef std::chrono::steady_clock Clock;
+
+        struct Worker
+        {
+            WorkStealingDeque<ITask*> deque;
+            /**
+             * @brief The moving average of the idle gaps of the thread, only used by the thread itself.
+             */
+            Clock::duration idleGap = Clock::duration::zero();
+        };
+
+        struct CurrentWorker
+        {
+            ThreadPool* pool;
+            uint32_t index;
+        };
+
+        static CurrentWorker& Current();
+
+        void Enqueue(ITask* task);
+        ITask* FindTask(uint32_t index);
+        void Execute(ITask* task);
+        void WorkerLoop(uint32_t index);
+        bool SpinForTask(Worker& worker, uint64_t epoch, const Clock::time_point& idleSince);
+
+        const uint32_t threadCount;
+        const TaskPriority threadPriority;
+        const std::string name;
+        const std::vector<uint32_t> affinity;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex injectionMutex;
+        InjectionQueue injection;
+        std::atomic<bool> injected;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::atomic<uint64_t> signalEpoch;
+        std::atomic<uint32_t> sleeping;
+        std::atomic<bool> terminated;
+        std::atomic<IdleStrategy::Mode> idleMode;
+        std::atomic<Microsecond> idleSpinPhase;
+        std::atomic<Microsecond> idleYieldPhase;
+        std::vector<std::thread> threads;
+        bool started;
+    };
+
+    inline ThreadPool::ThreadPool(uint32_t threadCount, TaskPriority threadPriority, const char* name,
+                                  std::vector<uint32_t> affinity)
+        : threadCount(threadCount == 0 ? DefaultThreadCount() : threadCount),
+          threadPriority(threadPriority),
+          name(name == nullptr ? "Pool" : name),
+          affinity(std::move(affinity)),
+          injected(false),
+          signalEpoch(0),
+          sleeping(0),
+          terminated(false),
+          idleMode(IdleStrategy::Mode::Park),
+          idleSpinPhase(0),
+          idleYieldPhase(0),
+          started(false)
+    {
+        workers.reserve(this->threadCount);
+        for (uint32_t index = 0; index < this->threadCount; ++index)
+        {
+            workers.emplace_back(new Worker());
+        }
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        Stop();
+        ITask* task = nullptr;
+        for (auto& worker : workers)
+        {
+            while (worker->deque.Take(task))
+            {
+                delete dynamic_cast<ActionTask*>(task);
+            }
+        }
+        while ((task = injection.Pop()) != nullptr)
+        {
+            delete dynamic_cast<ActionTask*>(task);
+        }
+    }
+
+    inline void ThreadPool::Start()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (started)
+        {
+            return;
+        }
+        terminated.store(false);
+        threads.reserve(threadCount);
+        for (uint32_t index = 0; index < threadCount; ++index)
+        {
+            threads.emplace_back([this, index]() { WorkerLoop(index); });
+        }
+        started = true;
+    }
+
+    inline void ThreadPool::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!started)
+            {
+                return;
+            }
+            terminated.store(true);
+            signalEpoch.fetch_add(1);
+        }
+        cond.notify_all();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        started = false;
+    }
+
+    inline void ThreadPool::Submit(Action task)
+    {
+        Enqueue(new ActionTask(std::move(task)));
+    }
+
+    inline void ThreadPool::Submit(ITask& task)
+    {
+        Enqueue(&task);
+    }
+
+    inline uint32_t ThreadPool::GetThreadCount() const
+    {
+        return threadCount;
+    }
+
+    inline const std::vector<uint32_t>& ThreadPool::GetAffinity() const
+    {
+        return affinity;
+    }
+
+    inline void ThreadPool::SetIdleStrategy(const IdleStrategy& strategy)
+    {
+        idleSpinPhase.store(strategy.spinPhase, std::memory_order_relaxed);
+        idleYieldPhase.store(strategy.yieldPhase, std::memory_order_relaxed);
+        idleMode.store(strategy.mode, std::memory_order_relaxed);
+    }
+
+    inline IdleStrategy ThreadPool::GetIdleStrategy() const
+    {
+        IdleStrategy strategy;
+        strategy.mode = idleMode.load(std::memory_order_relaxed);
+        strategy.spinPhase = idleSpinPhase.load(std::memory_order_relaxed);
+        strategy.yieldPhase = idleYieldPhase.load(std::memory_order_relaxed);
+        return strategy;
+    }
+
+    inline bool ThreadPool::IsWorkerThread() const
+    {
+        return Current().pool == this;
+    }
+
+    inline ThreadPool* ThreadPool::GetCurrent()
+    {
+        return Current().pool;
+    }
+
+    inline uint32_t ThreadPool::DefaultThreadCount()
+    {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads == 0 ? 1 : hardwareThreads;
+    }
+
+    inline ThreadPool::CurrentWorker& ThreadPool::Current()
+    {
+        static thread_local CurrentWorker current = {nullptr, 0};
+        return current;
+    }
+
+    inline void ThreadPool::Enqueue(ITask* task)
+    {
+        const CurrentWorker& current = Current();
+        if (current.pool == this)
+        {
+            workers[current.index]->deque.Push(task);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            injection.Push(task);
+            injected.store(true, std::memory_order_release);
+        }
+
+        signalEpoch.fetch_add(1);
+        if (sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cond.notify_one();
+        }
+    }
+
+    inline ITask* ThreadPool::FindTask(uint32_t index)
+    {
+        ITask* task = nullptr;
+        if (workers[index]->deque.Take(task))
+        {
+            return task;
+        }
+        if (injected.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            task = injection.Pop();
+            if (task != nullptr)
+            {
+                injected.store(!injection.Empty(), std::memory_order_release);
+                return task;
+            }
+        }
+        for (uint32_t offset = 1; offset < threadCount; ++offset)
+        {
+            if (workers[(index + offset) % threadCount]->deque.Steal(task))
+            {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    inline void ThreadPool::Execute(ITask* task)
+    {
+        try
+        {
+            if (task->Run())
+            {
+                Enqueue(task);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            LogFilter::Format<LogLevel::Error>("%s task failed: %s", name.c_str(), e.what());
+        }
+        catch (...)
+        {
+            LogFilter::Format<LogLevel::Error>("%s task failed with an unknown exception", name.c_str());
+        }
+    }
+
+    inline void ThreadPool::WorkerLoop(uint32_t index)
+    {
+        Current() = CurrentWorker{this, index};
+        ThisThread::SetName(name + "-" + std::to_string(index));
+        ThisThread::SetPriority(threadPriority);
+        if (!affinity.empty())
+        {
+            ThisThread::SetAffinity(affinity);
+        }
+        Worker& worker = *workers[index];
+        Clock::time_point idleSince;
+        bool idle = false;
+        for (;;)
+        {
+            const uint64_t epoch = signalEpoch.load();
+            ITask* task = FindTask(index);
+            if (task != nullptr)
+            {
+                if (idle)
+                {
+                    worker.idleGap += (Clock::now() - idleSince - worker.idleGap) / 8;
+                    idle = false;
+                }
+                Execute(task);
+                continue;
+            }
+            if (terminated.load())
+            {
+                break;
+            }
+            if (idleMode.load(std::memory_order_relaxed) != IdleStrategy::Mode::Park)
+            {
+                if (!idle)
+                {
+                    idleSince = Clock::now();
+                    idle = true;
+                }
+                if (SpinForTask(worker, epoch, idleSince))
+                {
+                    continue;
+                }
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            sleeping.fetch_add(1);
+            while (signalEpoch.load() == epoch && !terminated.load())
+            {
+                cond.wait(lock);
+            }
+            sleeping.fetch_sub(1);
+        }
+        Current() = CurrentWorker{nullptr, 0};
+    }
+
+    inline bool ThreadPool::SpinForTask(Worker& worker, uint64_t epoch, const Clock::time_point& idleSince)
+    {
+        const Clock::duration spinPhase = std::chrono::microseconds(idleSpinPhase.load(std::memory_order_relaxed));
+        const Clock::duration backoff =
+            spinPhase + std::chrono::microseconds(idleYieldPhase.load(std::memory_order_relaxed));
+        if (idleMode.load(std::memory_order_relaxed) == IdleStrategy::Mode::Backoff && worker.idleGap > backoff)
+        {
+            return false;
+        }
+        while (signalEpoch.load() == epoch && !terminated.load())
+        {
+            const IdleStrategy::Mode mode = idleMode.load(std::memory_order_relaxed);
+            if (mode == IdleStrategy::Mode::Park)
+            {
+                return false;
+            }
+            if (mode == IdleStrategy::Mode::BusySpin)
+            {
+                ThisThread::CpuRelax();
+                continue;
+            }
+            const Clock::duration elapsed = Clock::now() - idleSince;
+            if (elapsed < spinPhase)
+            {
+                ThisThread::CpuRelax();
+            }
+            else if (elapsed < backoff)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace Concurrency
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set to 0 to compile every trace point out of the library headers.
+ */
+#ifndef CONCURRENCY_TRACE_ENABLED
+#define CONCURRENCY_TRACE_ENABLED 1
+#endif
+
+namespace Concurrency
+{
+    /**
+     * @brief The kind of a recorded trace event.
+     */
+    enum class TraceEventType : uint16_t
+    {
+        /**
+         * @brief One execution of a job, spanning its duration.
+         */
+        Run,
+        /**
+         * @brief An execution took longer than the expected duration of the job.
+         */
+        DurationOverrun,
+        /**
+         * @brief The time monitor of the job counted an interval fault.
+         */
+        IntervalFault,
+        /**
+         * @brief A job became due while its previous execution was still running.
+         */
+        Missed,
+        /**
+         * @brief An execution was dropped by the overload policy of the scheduler.
+         */
+        Skipped
+    };
+
+    /**
+     * @brief One binary trace record.
+     */
+    struct TraceEvent
+    {
+        /**
+         * @brief The time of the event in nanoseconds of the steady clock, the start for a Run.
+         */
+        uint64_t timestamp;
+        /**
+         * @brief The duration of a Run in nanoseconds, 0 for the other events.
+         */
+        uint64_t duration;
+        /**
+         * @brief The id returned by TraceRecorder::RegisterJob.
+         */
+        uint32_t jobId;
+        TraceEventType type;
+        /**
+         * @brief The index of the recording thread, in the order the threads first recorded.
+         */
+        uint16_t thread;
+    };
+
+    /**
+     * @brief Collects binary trace events of the scheduler into per-thread buffers.
+     *
+     * Every recording thread owns a fixed-size single-producer ring, so recording is a clock read
+     * and a few plain stores with no lock and no allocation; a full ring drops the event and counts
+     * it. While tracing is disabled a trace point costs one relaxed load, and none at all when
+     * CONCURRENCY_TRACE_ENABLED is 0. Collect() drains the rings of all threads, and the events can
+     * then be written as a compact binary file or as Chrome trace JSON, which Perfetto and
+     * chrome://tracing load directly.
+     */
+    class TraceRecorder
+    {
+    public:
+        /**
+         * @brief The default number of events buffered per thread.
+         */
+        static constexpr std::size_t DEFAULT_BUFFER_CAPACITY = 1 << 16;
+
+        /**
+         * @brief Retrieves the singleton instance of the TraceRecorder class.
+         */
+        static TraceRecorder& GetInstance()
+        {
+            static TraceRecorder instance;
+            return instance;
+        }
+
+        /**
+         * @brief Checks whether trace points currently record events.
+         */
+        static bool IsEnabled()
+        {
+#if CONCURRENCY_TRACE_ENABLED
+            return enabled.load(std::memory_order_relaxed);
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Gets the current time in nanoseconds of the steady clock.
+         */
+        static uint64_t Now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        /**
+         * @brief Starts recording events.
+         *
+         * @param bufferCapacity The number of events buffered per thread, rounded up to a power of
+         * two. Applies to the threads recording for the first time.
+         */
+        void Enable(std::size_t bufferCapacity = DEFAULT_BUFFER_CAPACITY)
+        {
+            std::size_t capacity = 2;
+            while (capacity < bufferCapacity)
+            {
+                capacity *= 2;
+            }
+            this->bufferCapacity.store(capacity, std::memory_order_relaxed);
+            enabled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Stops recording events. The buffered events remain available to Collect().
+         */
+        void Disable()
+        {
+            enabled.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Registers the name of a job and gets the id its events are recorded with.
+         *
+         * @param name The name of the job.
+         * @return uint32_t The id of the job, never 0.
+         */
+        uint32_t RegisterJob(const char* name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobNames.emplace_back(name == nullptr ? "" : name);
+            return static_cast<uint32_t>(jobNames.size());
+        }
+
+        /**
+         * @brief Records an event into the buffer of the calling thread.
+         *
+         * @param type The kind of the event.
+         * @param jobId The id of the job the event belongs to.
+         * @param timestamp The time of the event, see Now().
+         * @param duration The duration of a Run in nanoseconds.
+         */
+        void Record(TraceEventType type, uint32_t jobId, uint64_t timestamp, uint64_t duration = 0)
+        {
+            ThreadBuffer& buffer = LocalBuffer();
+            const uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+            if (tail - buffer.head.load(std::memory_order_acquire) == buffer.capacity)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            buffer.events[tail & (buffer.capacity - 1)] = TraceEvent{timestamp, duration, jobId, type, buffer.thread};
+            buffer.tail.store(tail + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Moves the buffered events of all threads into a vector.
+         *
+         * @param events Receives the events, appended per thread in recording order.
+         * @return std::size_t The number of events appended.
+         */
+        std::size_t Collect(std::vector<TraceEvent>& events)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::size_t count = 0;
+            for (std::size_t index = 0; index < buffers.size();)
+            {
+                ThreadBuffer& buffer = *buffers[index];
+                const uint64_t tail = buffer.tail.load(std::memory_order_acquire);
+                uint64_t head = buffer.head.load(std::memory_order_relaxed);
+                for (; head != tail; ++head)
+                {
+                    events.push_back(buffer.events[head & (buffer.capacity - 1)]);
+                    ++count;
+                }
+                buffer.head.store(head, std::memory_order_release);
+                if (buffers[index].use_count() == 1)
+                {
+                    buffers.erase(buffers.begin() + static_cast<std::ptrdiff_t>(index));
+                }
+                else
+                {
+                    ++index;
+                }
+            }
+            return count;
+        }
+
+        /**
+         * @brief Gets the number of per-thread buffers held. The buffer of a thread that has
+         * exited is released by the next Collect().
+         */
+        std::size_t GetBufferCount() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return buffers.size();
+        }
+
+        /**
+         * @brief Gets the number of events dropped because the buffer of their thread was full.
+         */
+        uint64_t GetDroppedCount() const
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Writes events and the registered job names in the compact binary format.
+         *
+         * The format is the magic "CTRC", a uint32 version, a uint32 count of job names followed by
+         * each name as a uint32 length and its characters, then a uint64 count of events followed by
+         * the TraceEvent records. All integers are in the byte order of the writing machine.
+         *
+         * @param stream The binary stream to write to.
+         * @param events The events to be written.
+         */
+        void WriteBinary(std::ostream& stream, const std::vector<TraceEvent>& events) const
+        {
+            const uint32_t version = 1;
+            stream.write("CTRC", 4);
+            WriteValue(stream, version);
+            std::lock_guard<std::mutex> lock(mutex);
+            WriteValue(stream, static_cast<uint32_t>(jobNames.size()));
+            for (const std::string& name : jobNames)
+            {
+                WriteValue(stream, static_cast<uint32_t>(name.size()));
+                stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+            }
+            WriteValue(stream, static_cast<uint64_t>(events.size()));
+            stream.write(reinterpret_cast<const char*>(events.data()),
+                         static_cast<std::streamsize>(events.size() * sizeof(TraceEvent)));
+        }
+
+        /**
+         * @brief Writes events in the Chrome trace event JSON format.
+         *
+         * Runs become complete events, the other event types become instant events on the thread
+         * that recorded them.
+         *
+         * @param stream The text stream to write to.
+         * @param events The events to be written.
+         */
+        void WriteChromeTrace(std::ostream& stream, const std::vector<TraceEvent>& events) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stream << "{\"traceEvents\":[";
+            bool first = true;
+            for (const TraceEvent& event : events)
+            {
+                stream << (first ? "\n" : ",\n");
+                first = false;
+                stream << "{\"name\":\"";
+                WriteJsonString(stream, event.jobId >= 1 && event.jobId <= jobNames.size() ? jobNames[event.jobId - 1]
+                                                                                            : std::string("?"));
+                stream << "\",\"cat\":\"" << TypeName(event.type) << "\",\"pid\":1,\"tid\":" << event.thread
+                       << ",\"ts\":" << event.timestamp / 1000 << '.' << Fraction(event.timestamp);
+                if (event.type == TraceEventType::Run)
+                {
+                    stream << ",\"ph\":\"X\",\"dur\":" << event.duration / 1000 << '.' << Fraction(event.duration);
+                }
+                else
+                {
+                    stream << ",\"ph\":\"i\",\"s\":\"t\"";
+                }
+                stream << '}';
+            }
+            stream << "\n]}\n";
+        }
+
+    private:
+        struct ThreadBuffer
+        {
+            ThreadBuffer(std::size_t capacity, uint16_t thread)
+                : capacity(capacity), thread(thread), events(new TraceEvent[capacity]), head(0), tail(0)
+            {
+            }
+
+            const std::size_t capacity;
+            const uint16_t thread;
+            const std::unique_ptr<TraceEvent[]> events;
+            alignas(64) std::atomic<uint64_t> head;
+            alignas(64) std::atomic<uint64_t> tail;
+        };
+
+        TraceRecorder() : bufferCapacity(DEFAULT_BUFFER_CAPACITY), dropped(0), threadCount(0)
+        {
+        }
+
+        ThreadBuffer& LocalBuffer()
+        {
+            static thread_local std::shared_ptr<ThreadBuffer> local;
+            if (!local)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                local = std::make_shared<ThreadBuffer>(bufferCapacity.load(std::memory_order_relaxed), threadCount++);
+                buffers.push_back(local);
+            }
+            return *local;
+        }
+
+        template <typename T>
+        static void WriteValue(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static void WriteJsonString(std::ostream& stream, const std::string& text)
+        {
+            for (const char character : text)
+            {
+                if (character == '"' || character == '\\')
+                {
+                    stream << '\\' << character;
+                }
+                else if (static_cast<unsigned char>(character) >= 0x20)
+                {
+                    stream << character;
+                }
+            }
+        }
+
+        static std::string Fraction(uint64_t nanoseconds)
+        {
+            const unsigned remainder = static_cast<unsigned>(nanoseconds % 1000);
+            char digits[4] = {static_cast<char>('0' + remainder / 100), static_cast<char>('0' + remainder / 10 % 10),
+                              static_cast<char>('0' + remainder % 10), '\0'};
+            return digits;
+        }
+
+        static const char* TypeName(TraceEventType type)
+        {
+            switch (type)
+            {
+            case TraceEventType::Run:
+                return "run";
+            case TraceEventType::DurationOverrun:
+                return "overrun";
+            case TraceEventType::IntervalFault:
+                return "interval_fault";
+            case TraceEventType::Missed:
+                return "missed";
+            case TraceEventType::Skipped:
+                return "skipped";
+            }
+            return "unknown";
+        }
+
+        static inline std::atomic<bool> enabled{false};
+
+        std::atomic<std::size_t> bufferCapacity;
+        std::atomic<uint64_t> dropped;
+        mutable std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::vector<std::string> jobNames;
+        uint16_t threadCount;
+    };
+} // namespace Concurrency
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "ConcurrencyLog.hpp"
+#include "HighResolutionTimer.hpp"
+#include "IScheduler.hpp"
+#include "NativeThread.hpp"
+#include "RoutineTimeMonitor.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A log policy of BasicScheduler discarding every message at compile time.
+     *
+     * LogFilter is the log policy forwarding to ConcurrencyLog.
+     */
+    struct NullLogPolicy
+    {
+        template <LogLevel Level, typename... Args>
+        static void Format(const char*, Args...)
+        {
+        }
+    };
+
+    /**
+     * @brief A monitor policy of BasicScheduler recording nothing.
+     *
+     * PublishedRoutineTimeMonitor is the monitor policy recording the timing statistics of every job.
+     */
+    struct NullMonitorPolicy
+    {
+        NullMonitorPolicy(const Microsecond, const Microsecond)
+        {
+        }
+
+        void Start()
+        {
+        }
+
+        void Stop()
+        {
+        }
+
+        void IncrementIntervalFaultCount()
+        {
+        }
+    };
+
+    /**
+     * @brief An idle policy of BasicScheduler sleeping until the next deadline, as precise as the
+     * system timer.
+     */
+    struct SleepIdlePolicy
+    {
+        template <typename TimePoint>
+        void WaitUntil(const TimePoint& deadline)
+        {
+            std::this_thread::sleep_until(deadline);
+        }
+    };
+
+    /**
+     * @brief An idle policy of BasicScheduler spinning until the next deadline, which keeps one
+     * core busy for wakeups without timer latency.
+     */
+    struct SpinIdlePolicy
+    {
+        template <typename TimePoint>
+        void WaitUntil(const TimePoint& deadline)
+        {
+            while (TimePoint::clock::now() < deadline)
+            {
+                ThisThread::CpuRelax();
+            }
+        }
+    };
+
+    /**
+     * @brief An idle policy of BasicScheduler sleeping on a HighResolutionTimer, with an optional
+     * final spin phase. Needs std::chrono::steady_clock as the clock policy.
+     */
+    class PreciseIdlePolicy
+    {
+    public:
+        /**
+         * @brief Construct a new Precise Idle Policy object.
+         *
+         * @param spinPhase The final part of every wait spent spinning, in microseconds.
+         */
+        explicit PreciseIdlePolicy(Microsecond spinPhase = 0)
+            : timer(new HighResolutionTimer()), spinPhase(static_cast<std::chrono::microseconds::rep>(spinPhase))
+        {
+        }
+
+        void WaitUntil(const std::chrono::steady_clock::time_point& deadline)
+        {
+            timer->WaitUntil(deadline, spinPhase);
+        }
+
+    private:
+        std::unique_ptr<HighResolutionTimer> timer;
+        std::chrono::microseconds spinPhase;
+    };
+
+    /**
+     * @brief A cyclic scheduler specialized at compile time, running a fixed set of jobs on one thread.
+     *
+     * Where Scheduler and PooledScheduler reach every worker through IScheduledWorker, BasicScheduler
+     * knows the concrete type of each job: Run() expands into one dispatch per job, so the
+     * RunOnce() of a StaticWorker or of a final worker class is inlined into the loop. The
+     * features that the other schedulers pay for at runtime are policies, and the null policies
+     * compile them out:
+     * - ClockPolicy is a std::chrono clock, usually std::chrono::steady_clock.
+     * - IdlePolicy waits for the next deadline: SleepIdlePolicy, SpinIdlePolicy or PreciseIdlePolicy.
+     * - LogPolicy provides a static Format<Level>() like LogFilter, or NullLogPolicy.
+     * - MonitorPolicy is the per-job monitor, PublishedRoutineTimeMonitor or NullMonitorPolicy.
+     *
+     * With NullLogPolicy and NullMonitorPolicy the scheduler is header-only and needs no Concurrency
+     * library at all. A job whose execution came a whole interval or more late runs once for the
+     * latest slot that has passed, and its missed slots count as interval faults.
+     *
+     * The jobs are owned by the caller and must outlive the run. Stop() takes effect once the
+     * current wait has ended, which is at most the shortest job interval.
+     *
+     * @tparam ClockPolicy The clock the deadlines are computed with.
+     * @tparam IdlePolicy How the scheduler thread waits for the next deadline.
+     * @tparam LogPolicy Where timeouts and execution failures are logged.
+     * @tparam MonitorPolicy The monitor timing every execution of a job.
+     */
+    template <typename ClockPolicy, typename IdlePolicy, typename LogPolicy,
+              typename MonitorPolicy = NullMonitorPolicy>
+    class BasicScheduler
+    {
+    public:
+        typedef typename ClockPolicy::time_point TimePoint;
+
+        /**
+         * @brief A worker with its schedule and monitor, run by BasicScheduler::Run().
+         *
+         * @tparam Worker A type providing RunOnce(), GetWorkerName() and NotifyDurationTimeout(),
+         * such as StaticWorker or any IScheduledWorker.
+         */
+        template <typename Worker>
+        class Job
+        {
+        public:
+            /**
+             * @brief Construct a new Job object.
+             *
+             * @param worker The worker to be executed, which must outlive the job.
+             * @param interval The interval in milliseconds between each execution, at least 1.
+             * @param duration The expected duration in milliseconds of one execution, 0 for none.
+             */
+            Job(Worker& worker, Millisecond interval, Millisecond duration = 0)
+                : worker(worker),
+                  interval(std::chrono::duration_cast<typename ClockPolicy::duration>(
+                      std::chrono::milliseconds(interval == 0 ? 1 : interval))),
+                  durationMax(duration),
+                  monitor(duration * MicrosecondInMillisecond,
+                          (interval == 0 ? 1 : interval) * MicrosecondInMillisecond),
+                  executionErrorsCnt(0),
+                  msgCnt(0)
+            {
+            }
+
+            Job(const Job&) = delete;
+            Job& operator=(const Job&) = delete;
+
+            /**
+             * @brief Gets the worker executed by the job.
+             */
+            Worker& GetWorker() const
+            {
+                return worker;
+            }
+
+            /**
+             * @brief Gets the monitor of the job. A PublishedRoutineTimeMonitor can be snapshotted from any thread.
+             */
+            const MonitorPolicy& GetMonitor() const
+            {
+                return monitor;
+            }
+
+            /**
+             * @brief Gets the number of executions that threw. Safe to query from any thread.
+             */
+            uint32_t GetErrorCount() const
+            {
+                return executionErrorsCnt.load(std::memory_order_relaxed);
+            }
+
+        private:
+            friend class BasicScheduler;
+
+            Worker& worker;
+            const typename ClockPolicy::duration interval;
+            const Millisecond durationMax;
+            TimePoint deadline;
+            MonitorPolicy monitor;
+            std::atomic<uint32_t> executionErrorsCnt;
+            uint32_t msgCnt;
+        };
+
+        /**
+         * @brief Makes a Job, deducing the type of the worker.
+         */
+        template <typename Worker>
+        static Job<Worker> MakeJob(Worker& worker, Millisecond interval, Millisecond duration = 0)
+        {
+            return Job<Worker>(worker, interval, duration);
+        }
+
+        /**
+         * @brief Construct a new Basic Scheduler object.
+         *
+         * @param idle The idle policy, for policies taking parameters.
+         */
+        explicit BasicScheduler(IdlePolicy idle = IdlePolicy()) : idle(std::move(idle)), terminated(false)
+        {
+        }
+
+        /**
+         * @brief Stops the scheduler and joins its thread.
+         */
+        ~BasicScheduler()
+        {
+            Stop();
+        }
+
+        BasicScheduler(const BasicScheduler&) = delete;
+        BasicScheduler& operator=(const BasicScheduler&) = delete;
+
+        /**
+         * @brief Runs the jobs on the calling thread until Stop() is called. Every job first runs at once.
+         *
+         * @param jobs The jobs to be run.
+         */
+        template <typename... Jobs>
+        void Run(Jobs&... jobs)
+        {
+            static_assert(sizeof...(Jobs) > 0, "BasicScheduler::Run needs at least one job");
+            const TimePoint start = ClockPolicy::now();
+            ((jobs.deadline = start), ...);
+            while (!terminated.load(std::memory_order_relaxed))
+            {
+                TimePoint next = (TimePoint::max)();
+                (Dispatch(jobs, next), ...);
+                idle.WaitUntil(next);
+            }
+        }
+
+        /**
+         * @brief Runs the jobs on a thread of their own until Stop() is called.
+         *
+         * @param threadPriority The priority of the scheduler thread.
+         * @param jobs The jobs to be run.
+         * @return false if the scheduler is already running.
+         */
+        template <typename... Jobs>
+        bool Start(const TaskPriority threadPriority, Jobs&... jobs)
+        {
+            if (thread.joinable())
+            {
+                LogPolicy::template Format<LogLevel::Warning>("basic scheduler is already started");
+                return false;
+            }
+            terminated.store(false);
+            thread = std::thread([this, threadPriority, &jobs...]() {
+                ThisThread::SetPriority(threadPriority);
+                ThisThread::SetName("BasicScheduler");
+                Run(jobs...);
+            });
+            return true;
+        }
+
+        /**
+         * @brief Stops Run() after its current wait, and joins the thread of Start() unless called from it.
+         */
+        void Stop()
+        {
+            terminated.store(true);
+            if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+            {
+                thread.join();
+            }
+        }
+
+    private:
+        static constexpr uint32_t DURATION_MSG_INTERVAL = 60 * 1;
+
+        template <typename Worker>
+        void Dispatch(Job<Worker>& job, TimePoint& next)
+        {
+            const TimePoint now = ClockPolicy::now();
+            if (now >= job.deadline)
+            {
+                const typename ClockPolicy::duration lateness = now - job.deadline;
+                if (lateness >= job.interval)
+                {
+                    // The missed slots become the latest one that has passed.
+                    job.deadline += job.interval * (lateness / job.interval);
+                    job.monitor.IncrementIntervalFaultCount();
+                }
+                Execute(job, now);
+                job.deadline += job.interval;
+            }
+            next = (std::min)(next, job.deadline);
+        }
+
+        template <typename Worker>
+        void Execute(Job<Worker>& job, const TimePoint& begin)
+        {
+            job.monitor.Start();
+            try
+            {
+                job.worker.RunOnce();
+            }
+            catch (const std::exception& e)
+            {
+                job.executionErrorsCnt.fetch_add(1, std::memory_order_relaxed);
+                LogPolicy::template Format<LogLevel::Error>("worker %s execution failed: %s",
+                                                            job.worker.GetWorkerName(), e.what());
+            }
+            catch (...)
+            {
+                job.executionErrorsCnt.fetch_add(1, std::memory_order_relaxed);
+                LogPolicy::template Format<LogLevel::Error>("worker %s execution failed with an unknown exception",
+                                                            job.worker.GetWorkerName());
+            }
+            job.monitor.Stop();
+
+            if (job.durationMax > 0)
+            {
+                const Microsecond elapsed = static_cast<Microsecond>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(ClockPolicy::now() - begin).count());
+                const bool isTimeout = elapsed > job.durationMax * MicrosecondInMillisecond;
+                if (isTimeout && job.msgCnt++ % DURATION_MSG_INTERVAL == 0)
+                {
+                    LogPolicy::template Format<LogLevel::Warning>(
+                        "worker %s duration timeout, expected %llu ms, actual is %llu us", job.worker.GetWorkerName(),
+                        static_cast<unsigned long long>(job.durationMax), static_cast<unsigned long long>(elapsed));
+                }
+                job.worker.NotifyDurationTimeout(isTimeout);
+            }
+        }
+
+        IdlePolicy idle;
+        std::atomic<bool> terminated;
+        std::thread thread;
+    };
+} // namespace Concurrency
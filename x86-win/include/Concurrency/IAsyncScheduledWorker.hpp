@@ -0,0 +1,39 @@
+#pragma once
+
+#include "IScheduler.hpp"
+#include "Task.hpp"
+
+#if CONCURRENCY_HAS_COROUTINES
+
+namespace Concurrency
+{
+    /**
+     * @brief Interface for scheduled workers whose executions are coroutines.
+     *
+     * A worker waiting on I/O or timers implements RunOnceAsync() and co_awaits instead of
+     * blocking. PooledScheduler starts the coroutine on a pool thread and releases the thread as
+     * soon as the coroutine suspends; the execution completes on whichever thread resumes it, and
+     * the job is not dispatched again before it has. Any other scheduler drives the worker through
+     * RunOnce(), which blocks until the coroutine has completed.
+     */
+    class IAsyncScheduledWorker : public IScheduledWorker
+    {
+    public:
+        /**
+         * @brief Runs the worker's action once as a coroutine.
+         *
+         * @return Task<void> The not yet started coroutine.
+         */
+        virtual Task<void> RunOnceAsync() = 0;
+
+        /**
+         * @brief Runs the worker's action once, blocking until the coroutine has completed.
+         */
+        void RunOnce() override
+        {
+            SyncWait(RunOnceAsync());
+        }
+    };
+} // namespace Concurrency
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include "ConcurrencyLog.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief One log message handed to an IBatchLogSinker.
+     *
+     * The message is not null-terminated and is only valid for the duration of the LogBatch call.
+     */
+    struct LogRecord
+    {
+        LogLevel level;
+        const char* message;
+        std::size_t length;
+    };
+
+    /**
+     * @brief Interface for log sinkers that handle many messages at once.
+     *
+     * Sinkers writing to files or network connections implement LogBatch to amortize one write or
+     * send over many messages. AsyncLogSinker and MultiLogSinker deliver whole batches to such
+     * sinkers; a single message logged through the ILogSinker interface is delivered as a batch of one.
+     *
+     * Overriding LogBatch hides the std::span overload, so a sinker brings it back into scope:
+     *
+     * @code
+     * class FileLogSinker : public IBatchLogSinker
+     * {
+     * public:
+     *     using IBatchLogSinker::LogBatch;
+     *
+     *     void LogBatch(const LogRecord* records, std::size_t count) override;
+     * };
+     * @endcode
+     */
+    class IBatchLogSinker : public ILogSinker
+    {
+    public:
+        /**
+         * @brief Logs a batch of messages.
+         *
+         * @param records Pointer to the messages to be logged, in the order they were logged.
+         * @param count The number of messages.
+         */
+        virtual void LogBatch(const LogRecord* records, std::size_t count) = 0;
+
+#if defined(__cpp_lib_span)
+        /**
+         * @brief Logs a batch of messages.
+         *
+         * @param records The messages to be logged, in the order they were logged.
+         */
+        void LogBatch(std::span<const LogRecord> records)
+        {
+            LogBatch(records.data(), records.size());
+        }
+#endif
+
+        /**
+         * @brief Logs a message as a batch of one.
+         *
+         * @param level The log level of the message.
+         * @param message The log message to be logged.
+         */
+        void Log(const LogLevel level, const std::string& message) override
+        {
+            const LogRecord record = {level, message.data(), message.size()};
+            LogBatch(&record, 1);
+        }
+    };
+} // namespace Concurrency
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Concurrency
+{
+    template <typename Signature, std::size_t Capacity = 48, bool AllowHeap = false>
+    class InplaceFunction;
+
+    namespace Detail
+    {
+        template <typename T>
+        struct IsInplaceFunction : std::false_type
+        {
+        };
+
+        template <typename S, std::size_t C, bool H>
+        struct IsInplaceFunction<InplaceFunction<S, C, H>> : std::true_type
+        {
+        };
+
+        /**
+         * @brief The type-erased operations of an InplaceFunction target, shared by all capacities.
+         */
+        template <typename R, typename... Args>
+        struct InplaceOperations
+        {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*move)(void* from, void* to) noexcept;
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <typename F, typename R, typename... Args>
+        struct InlineTarget
+        {
+            static R Invoke(void* storage, Args&&... args)
+            {
+                return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+            }
+
+            static void Move(void* from, void* to) noexcept
+            {
+                new (to) F(std::move(*static_cast<F*>(from)));
+                static_cast<F*>(from)->~F();
+            }
+
+            static void Destroy(void* storage) noexcept
+            {
+                static_cast<F*>(storage)->~F();
+            }
+
+            static constexpr InplaceOperations<R, Args...> operations = {&Invoke, &Move, &Destroy};
+        };
+
+        template <typename F, typename R, typename... Args>
+        struct HeapTarget
+        {
+            static R Invoke(void* storage, Args&&... args)
+            {
+                return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+            }
+
+            static void Move(void* from, void* to) noexcept
+            {
+                new (to) F*(*static_cast<F**>(from));
+            }
+
+            static void Destroy(void* storage) noexcept
+            {
+                delete *static_cast<F**>(storage);
+            }
+
+            static constexpr InplaceOperations<R, Args...> operations = {&Invoke, &Move, &Destroy};
+        };
+    } // namespace Detail
+
+    /**
+     * @brief A move-only callable wrapper storing its target inline.
+     *
+     * Unlike std::function, the target is kept in a fixed buffer of Capacity bytes inside the
+     * wrapper, so constructing, moving and invoking never touch the allocator. A target that does
+     * not fit is rejected at compile time, unless AllowHeap is set, in which case it is moved to
+     * the heap instead. A target whose move constructor may throw, or that is over-aligned, does
+     * not fit however small it is, as moving the wrapper must not throw, so it also needs AllowHeap.
+     * A wrapper converts to another one of the same signature with at least the same capacity
+     * without re-wrapping its target.
+     *
+     * @tparam R The return type.
+     * @tparam Args The argument types.
+     * @tparam Capacity The size in bytes of the inline buffer.
+     * @tparam AllowHeap Whether targets too large for the inline buffer may be allocated on the heap.
+     */
+    template <typename R, typename... Args, std::size_t Capacity, bool AllowHeap>
+    class InplaceFunction<R(Args...), Capacity, AllowHeap>
+    {
+        static_assert(!AllowHeap || Capacity >= sizeof(void*), "InplaceFunction needs room for a pointer to use the heap");
+
+    public:
+        /**
+         * @brief Construct an empty Inplace Function object.
+         */
+        InplaceFunction() noexcept : operations(nullptr)
+        {
+        }
+
+        /**
+         * @brief Construct an empty Inplace Function object.
+         */
+        InplaceFunction(std::nullptr_t) noexcept : operations(nullptr)
+        {
+        }
+
+        /**
+         * @brief Construct a new Inplace Function object wrapping a callable.
+         *
+         * @param target The callable to be stored.
+         */
+        template <typename F, typename Target = typename std::decay<F>::type,
+                  typename = typename std::enable_if<!Detail::IsInplaceFunction<Target>::value>::type>
+        InplaceFunction(F&& target) : operations(nullptr)
+        {
+            static_assert(FitsInline<Target>() || AllowHeap,
+                          "callable does not fit into the InplaceFunction, increase Capacity or allow the heap");
+            Construct<Target>(std::forward<F>(target), std::integral_constant<bool, FitsInline<Target>()>());
+        }
+
+        /**
+         * @brief Move constructor. The source is left empty.
+         */
+        InplaceFunction(InplaceFunction&& other) noexcept : operations(nullptr)
+        {
+            TakeFrom(other);
+        }
+
+        /**
+         * @brief Converts a wrapper with a smaller or equal capacity. The source is left empty.
+         */
+        template <std::size_t OtherCapacity, bool OtherAllowHeap>
+        InplaceFunction(InplaceFunction<R(Args...), OtherCapacity, OtherAllowHeap>&& other) noexcept
+            : operations(nullptr)
+        {
+            static_assert(OtherCapacity <= Capacity, "the source InplaceFunction has a larger capacity");
+            static_assert(AllowHeap || !OtherAllowHeap, "the source InplaceFunction may hold a heap target");
+            TakeFrom(other);
+        }
+
+        InplaceFunction(const InplaceFunction&) = delete;
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+        /**
+         * @brief Move assignment. The source is left empty.
+         */
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                TakeFrom(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Destroys the stored target.
+         */
+        InplaceFunction& operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        ~InplaceFunction()
+        {
+            Reset();
+        }
+
+        /**
+         * @brief Invokes the stored target, which must not be empty.
+         */
+        R operator()(Args... args) const
+        {
+            return operations->invoke(storage, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Checks whether a target is stored.
+         */
+        explicit operator bool() const noexcept
+        {
+            return operations != nullptr;
+        }
+
+        /**
+         * @brief Checks whether a callable type is stored inline rather than on the heap.
+         */
+        template <typename F>
+        static constexpr bool FitsInline()
+        {
+            return sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible<F>::value;
+        }
+
+    private:
+        template <typename, std::size_t, bool>
+        friend class InplaceFunction;
+
+        typedef Detail::InplaceOperations<R, Args...> Operations;
+
+        template <typename Target, typename F>
+        void Construct(F&& target, std::true_type)
+        {
+            new (storage) Target(std::forward<F>(target));
+            operations = &Detail::InlineTarget<Target, R, Args...>::operations;
+        }
+
+        template <typename Target, typename F>
+        void Construct(F&& target, std::false_type)
+        {
+            new (storage) Target*(new Target(std::forward<F>(target)));
+            operations = &Detail::HeapTarget<Target, R, Args...>::operations;
+        }
+
+        template <typename Other>
+        void TakeFrom(Other& other) noexcept
+        {
+            if (other.operations != nullptr)
+            {
+                other.operations->move(other.storage, storage);
+                operations = other.operations;
+                other.operations = nullptr;
+            }
+        }
+
+        void Reset() noexcept
+        {
+            if (operations != nullptr)
+            {
+                operations->destroy(storage);
+                operations = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) mutable unsigned char storage[Capacity];
+        const Operations* operations;
+    };
+
+    /**
+     * @brief An allocation-free counterpart of Action.
+     *
+     * Action is a std::function, which allocates any target larger than its small buffer when it
+     * is constructed, however it is stored afterwards.
+     */
+    template <std::size_t Capacity = 48, bool AllowHeap = false>
+    using InplaceAction = InplaceFunction<void(), Capacity, AllowHeap>;
+
+    /**
+     * @brief An allocation-free counterpart of TimeoutCallback.
+     */
+    template <std::size_t Capacity = 48, bool AllowHeap = false>
+    using InplaceTimeoutCallback = InplaceFunction<void(const bool&), Capacity, AllowHeap>;
+} // namespace Concurrency
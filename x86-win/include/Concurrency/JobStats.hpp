@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "IScheduler.hpp"
+#include "RoutineTimeSnapshot.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief The statistics of one attached job, as handed to the visitor of
+     * PooledScheduler::CollectStats().
+     *
+     * The name and the histograms belong to the job and are only valid during the visit; a
+     * visitor keeping them must copy them.
+     */
+    struct JobStats
+    {
+        /**
+         * @brief The name of the worker or task hosted by the job.
+         */
+        const char* name;
+
+        /**
+         * @brief The interval of the job in microseconds, 0 for a triggered job without timeout.
+         */
+        Microsecond interval;
+
+        /**
+         * @brief The number of executions that threw.
+         */
+        uint32_t errorCount;
+
+        /**
+         * @brief The timing statistics published after the last execution. The number of completed
+         * executions is timing.sampleCount.
+         */
+        RoutineTimeSnapshot timing;
+
+        /**
+         * @brief The histogram of the execution durations, nullptr unless JobSpec::latencyHistograms is set.
+         */
+        const RoutineLatencyHistogram* durationHistogram;
+
+        /**
+         * @brief The histogram of the intervals between executions, nullptr unless
+         * JobSpec::latencyHistograms is set.
+         */
+        const RoutineLatencyHistogram* intervalHistogram;
+
+        /**
+         * @brief Whether the CPU fields of timing are accounted, see JobSpec::cpuAccounting.
+         */
+        bool cpuAccounting;
+    };
+
+    /**
+     * @brief An execution in progress, as handed to the visitor of PooledScheduler::CollectRunning().
+     *
+     * The name and the worker are only valid during the visit, which a Detach() of the job waits for.
+     */
+    struct RunningJob
+    {
+        /**
+         * @brief The name of the worker or task hosted by the job.
+         */
+        const char* name;
+
+        /**
+         * @brief The worker hosted by the job.
+         */
+        const IScheduledWorker* worker;
+
+        /**
+         * @brief The time the execution started.
+         */
+        std::chrono::steady_clock::time_point since;
+
+        /**
+         * @brief The time the execution has been running for, in microseconds.
+         */
+        Microsecond runningFor;
+
+        /**
+         * @brief The expected duration of one execution of the job in milliseconds, 0 if it has none.
+         */
+        Millisecond expectedDuration;
+
+        /**
+         * @brief The operating system identifier of the thread running the execution, see
+         * ThisThread::GetId(). For an asynchronous worker, the thread that started the coroutine.
+         */
+        uint64_t threadId;
+    };
+} // namespace Concurrency
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AtomicSharedPtr.hpp"
+#include "IBatchLogSinker.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A log sinker forwarding every message to several sinkers, each with its own minimum level.
+     *
+     * Registered with ConcurrencyLog, it lifts the single sinker limit: messages are offered to
+     * every added sinker whose minimum level they reach. Sinkers implementing IBatchLogSinker
+     * receive the batches delivered to this sinker filtered down to their level, the others receive
+     * the messages one at a time. Putting the MultiLogSinker behind an AsyncLogSinker moves all
+     * sink I/O to the background thread and gives every sinker whole batches.
+     *
+     * Delivery never takes a lock: the list of sinkers is a copy-on-write snapshot. A removed
+     * sinker may still receive the messages being delivered concurrently with Remove().
+     */
+    class MultiLogSinker : public IBatchLogSinker
+    {
+    public:
+        using IBatchLogSinker::LogBatch;
+
+        /**
+         * @brief Construct a new Multi Log Sinker object without any sinker.
+         */
+        MultiLogSinker() : sinkers(std::make_shared<const SinkerContainer>())
+        {
+        }
+
+        MultiLogSinker(const MultiLogSinker&) = delete;
+        MultiLogSinker& operator=(const MultiLogSinker&) = delete;
+
+        /**
+         * @brief Adds a sinker receiving the messages of at least a minimum level.
+         *
+         * @param sinker The sinker to be added, which must outlive its registration.
+         * @param minimumLevel The lowest level forwarded to the sinker.
+         */
+        void Add(ILogSinker& sinker, LogLevel minimumLevel = LogLevel::Trace)
+        {
+            std::lock_guard<std::mutex> lock(sinkersMutex);
+            const std::shared_ptr<const SinkerContainer> current = sinkers.Load();
+            std::shared_ptr<SinkerContainer> updated = std::make_shared<SinkerContainer>(*current);
+            updated->push_back(Sinker{&sinker, dynamic_cast<IBatchLogSinker*>(&sinker), minimumLevel});
+            sinkers.Store(std::move(updated));
+        }
+
+        /**
+         * @brief Removes a sinker.
+         *
+         * @param sinker The sinker to be removed.
+         * @return true if the sinker was added before.
+         */
+        bool Remove(ILogSinker& sinker)
+        {
+            std::lock_guard<std::mutex> lock(sinkersMutex);
+            const std::shared_ptr<const SinkerContainer> current = sinkers.Load();
+            std::shared_ptr<SinkerContainer> updated = std::make_shared<SinkerContainer>();
+            for (const Sinker& entry : *current)
+            {
+                if (entry.sinker != &sinker)
+                {
+                    updated->push_back(entry);
+                }
+            }
+            if (updated->size() == current->size())
+            {
+                return false;
+            }
+            sinkers.Store(std::move(updated));
+            return true;
+        }
+
+        /**
+         * @brief Forwards a message to the sinkers whose minimum level it reaches.
+         *
+         * @param level The log level of the message.
+         * @param message The log message to be logged.
+         */
+        void Log(const LogLevel level, const std::string& message) override
+        {
+            const std::shared_ptr<const SinkerContainer> current = sinkers.Load();
+            for (const Sinker& entry : *current)
+            {
+                if (IsAccepted(entry, level))
+                {
+                    entry.sinker->Log(level, message);
+                }
+            }
+        }
+
+        /**
+         * @brief Forwards a batch of messages, filtered by level, to every sinker.
+         *
+         * @param records Pointer to the messages to be logged.
+         * @param count The number of messages.
+         */
+        void LogBatch(const LogRecord* records, std::size_t count) override
+        {
+            const std::shared_ptr<const SinkerContainer> current = sinkers.Load();
+            for (const Sinker& entry : *current)
+            {
+                if (entry.batch != nullptr)
+                {
+                    ForwardBatch(entry, records, count);
+                }
+                else
+                {
+                    ForwardEach(entry, records, count);
+                }
+            }
+        }
+
+    private:
+        static constexpr std::size_t FILTER_CHUNK = 64;
+
+        struct Sinker
+        {
+            ILogSinker* sinker;
+            IBatchLogSinker* batch;
+            LogLevel minimumLevel;
+        };
+
+        typedef std::vector<Sinker> SinkerContainer;
+
+        static bool IsAccepted(const Sinker& entry, LogLevel level)
+        {
+            return static_cast<int>(level) >= static_cast<int>(entry.minimumLevel);
+        }
+
+        static void ForwardBatch(const Sinker& entry, const LogRecord* records, std::size_t count)
+        {
+            if (entry.minimumLevel == LogLevel::Trace)
+            {
+                entry.batch->LogBatch(records, count);
+                return;
+            }
+            LogRecord accepted[FILTER_CHUNK];
+            std::size_t acceptedCount = 0;
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                if (IsAccepted(entry, records[index].level))
+                {
+                    accepted[acceptedCount++] = records[index];
+                    if (acceptedCount == FILTER_CHUNK)
+                    {
+                        entry.batch->LogBatch(accepted, acceptedCount);
+                        acceptedCount = 0;
+                    }
+                }
+            }
+            if (acceptedCount > 0)
+            {
+                entry.batch->LogBatch(accepted, acceptedCount);
+            }
+        }
+
+        static void ForwardEach(const Sinker& entry, const LogRecord* records, std::size_t count)
+        {
+            std::string message;
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                if (IsAccepted(entry, records[index].level))
+                {
+                    message.assign(records[index].message, records[index].length);
+                    entry.sinker->Log(records[index].level, message);
+                }
+            }
+        }
+
+        AtomicSharedPtr<const SinkerContainer> sinkers;
+        std::mutex sinkersMutex;
+    };
+} // namespace Concurrency
@@ -0,0 +1,2944 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include "AtomicSharedPtr.hpp"
+#include "DeadlineQueue.hpp"
+#include "HighResolutionTimer.hpp"
+#include "IAsyncScheduledWorker.hpp"
+#include "IScheduler.hpp"
+#include "IdleStrategy.hpp"
+#include "InplaceFunction.hpp"
+#include "IntrusivePtr.hpp"
+#include "JobSpec.hpp"
+#include "JobStats.hpp"
+#include "LogFilter.hpp"
+#include "NativeThread.hpp"
+#include "RoutineTimeSnapshot.hpp"
+#include "ThreadPlacement.hpp"
+#include "ThreadPool.hpp"
+#include "TraceRecorder.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief The order in which a PooledScheduler hands due jobs to its pool.
+     */
+    enum class DispatchPolicy : int
+    {
+        /**
+         * @brief Due jobs are submitted at once and queue up in the pool in the order they became due.
+         */
+        Immediate,
+        /**
+         * @brief Due jobs wait in a ready queue while every pool thread is busy, and the job whose
+         * execution must complete first runs next. An execution must complete one interval after
+         * it became due.
+         */
+        EarliestDeadlineFirst,
+        /**
+         * @brief Due jobs wait in a ready queue while every pool thread is busy, and the job with
+         * the shortest interval runs next.
+         */
+        RateMonotonic
+    };
+
+    /**
+     * @brief What a PooledScheduler does with a ready execution that can no longer meet its deadline.
+     */
+    enum class OverloadPolicy : int
+    {
+        /**
+         * @brief The execution runs late.
+         */
+        RunLate,
+        /**
+         * @brief The execution is dropped and counted as an interval fault of the job.
+         */
+        SkipLate,
+        /**
+         * @brief The execution is dropped and counted as an interval fault if the priority of the
+         * job is below the shedding priority, and runs late otherwise.
+         */
+        ShedLowPriority
+    };
+
+    /**
+     * @class PooledScheduler
+     * @brief A scheduler that dispatches its cyclical jobs onto a shared, fixed-size thread pool.
+     *
+     * Scheduler backs every attached worker with a CyclicalWorker owning its own Thread. The
+     * PooledScheduler keeps each attached worker as a lightweight timer entry instead: a single
+     * dispatch thread determines which entries are due and hands them to a ThreadPool, so hundreds
+     * of mostly sleeping periodic jobs share a handful of threads. Every entry keeps its own
+     * RoutineTimeMonitor, and a job never runs concurrently with itself.
+     *
+     * The next fire time of every job is kept in a DeadlineQueue, so the dispatch thread sleeps
+     * exactly until the earliest deadline and each dispatch costs O(log n) in the number of jobs.
+     *
+     * Attach and Detach never block dispatch: the deadline queue is owned by the dispatch thread
+     * alone, new jobs reach it through a lock-free inbox, detached jobs reach it through the
+     * lock-free wake list to have their entry removed, and the list of attached jobs is a
+     * copy-on-write snapshot. Every job has at most one entry in the queue, which a wake moves to
+     * an earlier deadline in place. The attaching thread pays for this instead: every Attach and
+     * Detach copies the whole job list, so attaching n jobs one at a time costs O(n^2) reference
+     * copies. Large sets of jobs should be attached with AttachBatch(), which copies the list once
+     * per batch.
+     *
+     * The records of the jobs attached together share one allocation taken from a memory
+     * resource, and are referenced through intrusive counters rather than shared_ptr.
+     */
+    class PooledScheduler : public IScheduler, public ITask
+    {
+    public:
+        /**
+         * @brief The inline capacity in bytes for the actions and callbacks of the attached tasks.
+         *
+         * InplaceAction and InplaceTimeoutCallback targets up to this size are stored inside the job
+         * record without any allocation. An Action or TimeoutCallback is a std::function: the
+         * wrapper object is moved into the record, but a capture too large for the small buffer
+         * of std::function stays on the heap, where std::function allocated it. Invoking either
+         * never allocates.
+         */
+        static constexpr std::size_t ACTION_CAPACITY = 64;
+
+        /**
+         * @brief Constructor for the PooledScheduler class.
+         *
+         * @param workerTaskPriority The priority of the pool threads and of the dispatch thread.
+         * @param poolSize The number of pool threads, 0 selects the number of hardware threads.
+         * @param resource The memory resource the job records and the job list are allocated from,
+         * nullptr selects a synchronized pool owned by the scheduler. The resource must be thread-safe
+         * and outlive the scheduler.
+         */
+        explicit PooledScheduler(TaskPriority workerTaskPriority, uint32_t poolSize = 0,
+                                 std::pmr::memory_resource* resource = nullptr);
+
+        /**
+         * @brief Destructor for the PooledScheduler class, deactivating it. Like Deactivate(), it
+         * must not run on a thread of the scheduler's own pool or lanes.
+         */
+        ~PooledScheduler(void) override;
+
+        PooledScheduler(const PooledScheduler&) = delete;
+        PooledScheduler& operator=(const PooledScheduler&) = delete;
+
+        /**
+         * @brief Attaches a scheduled worker to the scheduler with a specified interval and thread priority.
+         *
+         * Pooled jobs share the pool threads, so the thread priority of an individual job is not
+         * applied; all jobs run at the workerTaskPriority given to the constructor. A worker
+         * implementing IAsyncScheduledWorker is run through RunOnceAsync() and holds a pool thread
+         * only while its coroutine is not suspended.
+         *
+         * @param scheduleItem The scheduled worker to attach.
+         * @param interval The interval at which the worker should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the worker.
+         */
+        void Attach(IScheduledWorker& scheduleItem, Millisecond interval, const TaskPriority threadPriority) override;
+
+        /**
+         * @brief Attaches a scheduled worker to the scheduler with a specified thread priority, interval and duration.
+         *
+         * @param scheduleItem The scheduled worker to attach.
+         * @param threadPriority The priority requested for the worker.
+         * @param interval The interval at which the worker should be executed, 0 to run it back to back.
+         * @param duration The maximum expected duration of one execution, 0 disables the timeout notification.
+         */
+        void Attach(IScheduledWorker& scheduleItem, const TaskPriority threadPriority, Millisecond interval,
+                    Millisecond duration) override;
+
+        /**
+         * @brief Attaches a scheduled worker running on a placement of threads.
+         *
+         * Jobs placed on processors run on a lane of pool threads pinned to these processors, one
+         * thread per processor, shared by all jobs placed on the same processors. A placement that
+         * cannot be resolved, such as a missing NUMA node or an unknown job to follow, falls back to
+         * the main pool with a warning.
+         *
+         * @param scheduleItem The scheduled worker to attach.
+         * @param interval The interval at which the worker should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the worker.
+         * @param placement The processors the worker runs on.
+         */
+        void Attach(IScheduledWorker& scheduleItem, Millisecond interval, const TaskPriority threadPriority,
+                    const ThreadPlacement& placement);
+
+        /**
+         * @brief Attaches a scheduled worker with an interval in microseconds.
+         *
+         * Sub-millisecond intervals need a precise dispatch thread, see SetDispatchTiming().
+         *
+         * @param scheduleItem The scheduled worker to attach.
+         * @param interval The interval at which the worker should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the worker.
+         * @param timing Whether deadlines follow the dispatch times or a fixed rate.
+         * @param catchUp What the worker does about executions it fell behind on.
+         */
+        void Attach(IScheduledWorker& scheduleItem, std::chrono::microseconds interval,
+                    const TaskPriority threadPriority, TimingMode timing,
+                    CatchUpPolicy catchUp = CatchUpPolicy::FireOnce);
+
+        /**
+         * @brief Attaches a task with a specified name, action, interval and thread priority to the scheduler.
+         *
+         * @param name The name of the task to be attached.
+         * @param action The action to be executed at the specified interval.
+         * @param interval The interval at which the action should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the task.
+         */
+        void Attach(const char* name, Action action, Millisecond interval, const TaskPriority threadPriority) override;
+
+        /**
+         * @brief Attaches a task with a specified name, action, interval, thread priority and timeout callback to the
+         * scheduler.
+         *
+         * @param name The name of the task to be attached.
+         * @param action The action to be executed at the specified interval.
+         * @param interval The interval at which the action should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the task.
+         * @param callback The callback function to be called with the timeout state after every execution, an
+         * execution times out when it takes longer than the interval.
+         */
+        void Attach(const char* name, Action action, Millisecond interval, const TaskPriority threadPriority,
+                    TimeoutCallback callback) override;
+
+        /**
+         * @brief Attaches a task running an allocation-free action.
+         *
+         * The action is moved into the job record as is, so neither attaching nor running the task
+         * touches the allocator. Its capacity must not exceed ACTION_CAPACITY.
+         *
+         * @param name The name of the task to be attached.
+         * @param action The action to be executed at the specified interval.
+         * @param interval The interval at which the action should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the task.
+         */
+        template <std::size_t Capacity, bool AllowHeap>
+        void Attach(const char* name, InplaceAction<Capacity, AllowHeap> action, Millisecond interval,
+                    const TaskPriority threadPriority);
+
+        /**
+         * @brief Attaches a task running an allocation-free action with an allocation-free timeout callback.
+         *
+         * @param name The name of the task to be attached.
+         * @param action The action to be executed at the specified interval.
+         * @param interval The interval at which the action should be executed, 0 to run it back to back.
+         * @param threadPriority The priority requested for the task.
+         * @param callback The callback to be called with the timeout state after every execution, an execution
+         * times out when it takes longer than the interval.
+         */
+        template <std::size_t Capacity, bool AllowHeap, std::size_t CallbackCapacity, bool CallbackAllowHeap>
+        void Attach(const char* name, InplaceAction<Capacity, AllowHeap> action, Millisecond interval,
+                    const TaskPriority threadPriority, InplaceTimeoutCallback<CallbackCapacity, CallbackAllowHeap> callback);
+
+        /**
+         * @brief Attaches a batch of jobs at once.
+         *
+         * The job records are allocated contiguously in a single block, published with a single
+         * update of the job list and handed to the dispatch thread with a single wakeup. The job
+         * list is copied once for the batch, where attaching the jobs one by one copies it once
+         * per job.
+         *
+         * @param specs Pointer to the descriptions of the jobs to attach.
+         * @param count The number of jobs to attach.
+         */
+        void AttachBatch(const JobSpec* specs, std::size_t count);
+
+        /**
+         * @brief Attaches a batch of jobs at once, moving their actions and callbacks into the scheduler.
+         *
+         * @param specs The descriptions of the jobs to attach.
+         */
+        void AttachBatch(std::vector<JobSpec> specs);
+
+#if defined(__cpp_lib_span)
+        /**
+         * @brief Attaches a batch of jobs at once.
+         *
+         * @param specs The descriptions of the jobs to attach.
+         */
+        void AttachBatch(std::span<const JobSpec> specs);
+#endif
+
+        /**
+         * @brief Detaches every job hosting the specified scheduled worker.
+         *
+         * No execution of the worker is started after this method returns. Called from a thread
+         * that is not a pool thread, Detach also waits until a running execution has completed,
+         * including a suspended coroutine of an IAsyncScheduledWorker, so the caller must not hold
+         * anything that execution waits for.
+         *
+         * Called from a pool thread, from a job, a submitted action or the execution of the worker
+         * itself, Detach returns at once: an execution of the worker queued behind the caller
+         * could never start while the caller waited for it. A dispatched execution that has not
+         * started yet is discarded when it reaches a pool thread, but one that has started may
+         * still be running when Detach returns. A coroutine detaching its own job must do so while
+         * it runs on a pool thread.
+         *
+         * @param scheduleItem The scheduled worker to detach.
+         * @return true if at least one job was detached.
+         */
+        bool Detach(IScheduledWorker& scheduleItem);
+
+        /**
+         * @brief Detaches every job whose worker has the specified name.
+         *
+         * @param name The name of the worker or task to detach.
+         * @return true if at least one job was detached.
+         */
+        bool Detach(const char* name);
+
+        /**
+         * @brief Runs the job hosting a scheduled worker as soon as possible, ahead of its deadline.
+         *
+         * Lets a producer hand data to a consumer job without waiting for its next interval. The
+         * following execution is due one interval after the woken one. Waking a job that is
+         * executing runs it again right after the execution completes, and wakes arriving before
+         * the woken execution has been dispatched are coalesced. Safe from any thread, lock-free.
+         *
+         * @param scheduleItem The scheduled worker to wake.
+         * @return true if the worker is attached.
+         */
+        bool Wake(const IScheduledWorker& scheduleItem);
+
+        /**
+         * @brief Runs the job whose worker has the specified name as soon as possible.
+         *
+         * @param name The name of the worker or task to wake.
+         * @return true if such a job is attached.
+         */
+        bool Wake(const char* name);
+
+        class Trigger;
+
+        /**
+         * @brief Attaches a scheduled worker that runs when it is notified rather than on an interval.
+         *
+         * A job reacting to incoming data would otherwise poll at a short interval and occupy a
+         * pool thread even when nothing arrived. A triggered job costs nothing until its trigger
+         * is notified, and is then dispatched at once. Notifications arriving before the notified
+         * execution has been dispatched are coalesced, and one arriving during an execution runs
+         * the worker again right after it.
+         *
+         * @param scheduleItem The scheduled worker to attach.
+         * @param threadPriority The priority requested for the worker.
+         * @param maxLatency The longest time in milliseconds the worker waits for a notification
+         * after its last execution before it runs anyway, 0 to wait indefinitely.
+         * @return Trigger The handle notifying the job.
+         */
+        Trigger AttachTriggered(IScheduledWorker& scheduleItem, const TaskPriority threadPriority,
+                                Millisecond maxLatency = 0);
+
+        /**
+         * @brief Gets a handle notifying the job whose worker has the specified name.
+         *
+         * Meant for jobs attached through AttachBatch() with JobSpec::triggered set, but wakes
+         * periodic jobs as well, like Wake().
+         *
+         * @param name The name of the worker or task to be notified.
+         * @return Trigger The handle, empty if no such job is attached.
+         */
+        Trigger GetTrigger(const char* name);
+
+        /**
+         * @brief Gets the timing statistics of the job hosting the specified scheduled worker.
+         *
+         * The statistics are published by the job after each execution. Reading them never blocks
+         * the job, and is safe from any thread.
+         *
+         * @param scheduleItem The scheduled worker whose job is inspected.
+         * @param snapshot Receives the statistics of the first matching job.
+         * @return true if a job hosting the worker is attached.
+         */
+        bool GetStatistics(const IScheduledWorker& scheduleItem, RoutineTimeSnapshot& snapshot) const;
+
+        /**
+         * @brief Gets the timing statistics of the job whose worker has the specified name.
+         *
+         * @param name The name of the worker or task whose job is inspected.
+         * @param snapshot Receives the statistics of the first matching job.
+         * @return true if a job with that name is attached.
+         */
+        bool GetStatistics(const char* name, RoutineTimeSnapshot& snapshot) const;
+
+        /**
+         * @brief Copies the latency histograms of the job whose worker has the specified name.
+         *
+         * Only jobs attached with JobSpec::latencyHistograms set record histograms. Combine with a
+         * LatencyWindow to obtain the percentiles of the last scrape interval.
+         *
+         * @param name The name of the worker or task whose job is inspected.
+         * @param duration Receives the histogram of the execution durations in microseconds.
+         * @param interval Receives the histogram of the intervals between executions in microseconds.
+         * @return true if a job with that name is attached and records histograms.
+         */
+        bool GetLatencyHistograms(const char* name, RoutineLatencyHistogram& duration,
+                                  RoutineLatencyHistogram& interval) const;
+
+        /**
+         * @brief Calls a visitor with the statistics of every attached job.
+         *
+         * Walks the copy-on-write snapshot of the job list and reads every job's published
+         * statistics, so collecting neither locks the job list nor waits for a running job, and
+         * dispatch continues meanwhile. Jobs attached or detached during the walk may be missed
+         * or visited once more. Safe from any thread.
+         *
+         * @param visitor Called with a const JobStats& per job.
+         * @return std::size_t The number of jobs visited.
+         */
+        template <typename Visitor>
+        std::size_t CollectStats(Visitor visitor) const;
+
+        /**
+         * @brief Calls a visitor for every execution in progress.
+         *
+         * Every job publishes the start of its execution with two atomic stores, so a watchdog can
+         * spot an execution that hangs while it is still running, rather than once it returns.
+         * Costs one atomic load per attached job, takes no lock and never pauses dispatch. Safe
+         * from any thread.
+         *
+         * A job is pinned while it is visited: a Detach() of it from another thread does not return
+         * before the visitor does, so the worker of the execution stays valid throughout the visit.
+         * The visitor itself may detach the job, which then waits for the execution to complete
+         * but not for the visit.
+         *
+         * @param visitor Called with a const RunningJob& per executing job.
+         * @return std::size_t The number of executions visited.
+         */
+        template <typename Visitor>
+        std::size_t CollectRunning(Visitor visitor) const;
+
+        /**
+         * @brief Notifies the worker of an execution in progress of its duration timeout at once,
+         * through NotifyDurationTimeout(true), rather than when the execution returns.
+         *
+         * The end of the execution then does not notify the worker of the timeout again, so the
+         * worker hears of every overrun once. Must be called from the visitor of CollectRunning(),
+         * which keeps the worker valid.
+         *
+         * @param execution The execution being visited.
+         * @return false if the execution has completed or was reported before.
+         */
+        bool ReportDurationTimeout(const RunningJob& execution) const;
+
+        /**
+         * @brief Submits a one-shot action for execution on the pool.
+         *
+         * Submitted from a job or task already running on the pool, the action is queued on the
+         * calling thread's own deque and idle pool threads steal it from there; see ThreadPool.
+         * Actions submitted while the scheduler is inactive run once it is activated.
+         *
+         * @param action The action to be executed once.
+         */
+        void Submit(Action action);
+
+        /**
+         * @brief Submits a task for execution on the pool.
+         *
+         * The task is submitted again every time its Run() returns true. It must outlive its last
+         * execution.
+         *
+         * @param task The task to be executed.
+         */
+        void Submit(ITask& task);
+
+        /**
+         * @brief Sets how precisely the dispatch thread wakes up for deadlines.
+         *
+         * Must be called while the scheduler is inactive. With a precise window, the dispatch
+         * thread sleeps on a HighResolutionTimer for the last part of every wait and optionally
+         * spins for the final microseconds, so sub-millisecond fixed-rate jobs are dispatched on
+         * time rather than at the next system timer tick.
+         *
+         * @param timing The dispatch timing, the default waits on a condition variable only.
+         */
+        void SetDispatchTiming(const DispatchTiming& timing);
+
+        /**
+         * @brief Sets how the idle threads of the main pool wait for the next due job.
+         *
+         * A spinning pool picks up a due job without a kernel wakeup, at the cost of keeping
+         * its idle threads on their processors. Can be called at any time.
+         *
+         * @param strategy The idle strategy of the main pool threads.
+         */
+        void SetIdleStrategy(const IdleStrategy& strategy);
+
+        /**
+         * @brief Sets how the idle threads of the lane a placement resolves to wait for their
+         * next due job.
+         *
+         * Placing latency-critical jobs on a lane of their own and letting only that lane spin
+         * gives those jobs fast wakeups while background jobs on the main pool keep parking.
+         *
+         * @param placement The placement whose lane is configured, created if it does not exist
+         * yet. A placement without processors configures the main pool.
+         * @param strategy The idle strategy of the lane threads.
+         */
+        void SetIdleStrategy(const ThreadPlacement& placement, const IdleStrategy& strategy);
+
+        /**
+         * @brief Sets the order in which due jobs get the pool threads when the pool is saturated.
+         *
+         * Must be called while the scheduler is inactive. With a rationing policy, the dispatch
+         * thread keeps at most one due job per main pool thread in the pool and the others in a
+         * ready queue ordered by the policy, so under overload the most urgent jobs keep their
+         * timing instead of all jobs slipping equally. Jobs placed on lanes and asynchronous jobs
+         * are always submitted at once.
+         *
+         * @param policy The order of the ready queue.
+         * @param overload What happens to ready executions that have missed their deadline.
+         * @param shedPriority The priority below which ShedLowPriority drops late executions.
+         */
+        void SetDispatchPolicy(DispatchPolicy policy, OverloadPolicy overload = OverloadPolicy::RunLate,
+                               TaskPriority shedPriority = 0);
+
+        /**
+         * @brief Starts the pool threads and the dispatch thread.
+         */
+        void Activate();
+
+        /**
+         * @brief Stops dispatching, waits for the running jobs to complete and joins all threads.
+         *
+         * Suspended executions of IAsyncScheduledWorker jobs are waited for as well; their delays
+         * keep firing until they have completed.
+         *
+         * Must not be called from a job or task running on the scheduler's own pool or lanes,
+         * which would have to join the calling thread: such a call logs an error and is ignored,
+         * leaving the scheduler active. A job shutting down its scheduler hands the call to
+         * another thread instead.
+         */
+        void Deactivate();
+
+        /**
+         * @brief Executes one pass of the dispatch loop.
+         * @return bool True if the scheduler continues running,
+         *             false if termination was requested.
+         *
+         * Moves newly posted jobs into the deadline queue, hands every job whose deadline has
+         * passed to the pool or to the ready queue, feeds the ready queue to the idle pool threads,
+         * then sleeps until the next deadline or until a job is posted or a pool thread frees up.
+         */
+        bool Run() override;
+
+        /**
+         * @brief Gets the number of pool threads executing the attached jobs.
+         *
+         * @return uint32_t The number of pool threads.
+         */
+        uint32_t GetPoolSize() const;
+
+#if CONCURRENCY_HAS_COROUTINES
+        class TimerAwaiter;
+        class PoolAwaiter;
+
+        /**
+         * @brief Suspends the awaiting coroutine for a delay, without blocking a pool thread.
+         *
+         * The dispatch thread resumes the coroutine on a pool thread once the delay has passed.
+         * Meant for the RunOnceAsync() coroutines of IAsyncScheduledWorker jobs:
+         * `co_await scheduler.Delay(5);`
+         *
+         * @param delay The delay in milliseconds.
+         */
+        TimerAwaiter Delay(Millisecond delay);
+
+        /**
+         * @brief Suspends the awaiting coroutine until a point in time, without blocking a pool thread.
+         *
+         * @param deadline The time at which the coroutine is resumed on a pool thread.
+         */
+        TimerAwaiter DelayUntil(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Moves the awaiting coroutine onto a pool thread.
+         *
+         * A coroutine resumed by an I/O completion on a foreign thread awaits this to continue on
+         * the pool and release the completing thread.
+         */
+        PoolAwaiter Schedule();
+#endif
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+        typedef InplaceAction<ACTION_CAPACITY, true> ActionStorage;
+        typedef InplaceTimeoutCallback<ACTION_CAPACITY, true> CallbackStorage;
+
+        class PooledJob;
+        class JobBlock;
+        typedef IntrusivePtr<PooledJob> Item;
+        typedef std::pmr::vector<Item> ScheduleContainer;
+
+        /**
+         * @brief Keeps PooledJob::queueIndex up to date for the deadline queue.
+         */
+        struct QueuePosition
+        {
+            static void Placed(Item& job, std::size_t index);
+            static void Removed(Item& job);
+        };
+
+        /**
+         * @brief Adapts an action and an optional timeout callback to IScheduledWorker.
+         */
+        class ActionWorker : public IScheduledWorker
+        {
+        public:
+            ActionWorker(const char* name, ActionStorage action, CallbackStorage callback);
+            void RunOnce() override;
+            const char* GetWorkerName() const override;
+            void NotifyDurationTimeout(const bool& isTimeout) const override;
+
+        private:
+            const std::string name;
+            ActionStorage action;
+            CallbackStorage callback;
+        };
+
+        /**
+         * @brief The cold part of a job record: the hosted worker and its execution statistics.
+         *
+         * Only the thread holding the claimed execution touches it: the pool thread running the
+         * job, or the dispatch thread dropping an execution it has not yet handed to the pool.
+         */
+        class JobExecutor
+        {
+        public:
+            JobExecutor(IScheduledWorker& hostWorker, Microsecond interval, Millisecond duration, bool latencyHistograms,
+                        bool cpuAccounting);
+
+            /**
+             * @brief Runs the hosted worker once, monitoring its duration.
+             */
+            void RunOnce();
+
+#if CONCURRENCY_HAS_COROUTINES
+            /**
+             * @brief Checks whether the hosted worker is an IAsyncScheduledWorker.
+             */
+            bool IsAsync() const;
+
+            /**
+             * @brief Starts the coroutine of the hosted worker, which is monitored until FinishAsync().
+             *
+             * @param completion Called on the thread completing the coroutine, possibly before StartAsync returns.
+             * @param context The argument passed to the completion.
+             */
+            void StartAsync(TaskPromiseBase::Completion completion, void* context);
+
+            /**
+             * @brief Releases the completed coroutine and ends monitoring the execution.
+             */
+            void FinishAsync();
+#endif
+
+            /**
+             * @brief Gets the worker hosted by the job.
+             */
+            IScheduledWorker& GetWorker() const;
+
+            /**
+             * @brief Gets the statistics published after the last execution. Safe to call from any thread.
+             */
+            RoutineTimeSnapshot GetStatistics() const;
+
+            /**
+             * @brief Gets the number of executions that threw. Safe to call from any thread.
+             */
+            uint32_t GetErrorCount() const;
+
+            /**
+             * @brief Gets the execution in progress. Safe to call from any thread.
+             *
+             * @param since Receives the time the execution started.
+             * @param threadId Receives the identifier of the thread that started it.
+             * @return false if the job is not executing.
+             */
+            bool GetRunning(Clock::time_point& since, uint64_t& threadId) const;
+
+            /**
+             * @brief Takes over notifying the worker of the timeout of the execution started at a
+             * time, which End() then leaves out. Safe to call from any thread.
+             *
+             * @param since The start of the execution, as returned by GetRunning().
+             * @return false if that execution has ended or its timeout was claimed before.
+             */
+            bool ClaimTimeout(const Clock::time_point& since);
+
+            /**
+             * @brief Gets the expected duration of one execution in milliseconds, 0 if it has none.
+             */
+            Millisecond GetDurationLimit() const;
+
+            /**
+             * @brief Gets the time monitor of the job, for reading its histograms from any thread.
+             */
+            const PublishedRoutineTimeMonitor& GetMonitor() const;
+
+            /**
+             * @brief Records a Missed trace event, the job became due again while it was running.
+             */
+            void TraceMissed();
+
+            /**
+             * @brief Counts an execution dropped by the overload policy as an interval fault.
+             */
+            void Skip();
+
+        private:
+            static constexpr uint32_t DURATION_MSG_INTERVAL = 60 * 1;
+
+            void Begin();
+            void End();
+            void HandleFailure();
+            uint32_t GetTraceId();
+            void Trace(bool isTimeout);
+
+            IScheduledWorker* hostWorker;
+            const Millisecond durationMax;
+            std::atomic<uint32_t> executionErrorsCnt;
+            PublishedRoutineTimeMonitor timeMonitor;
+            uint32_t scheduledCount;
+            uint32_t msgCnt;
+            uint32_t traceId;
+            bool tracing;
+            uint64_t traceStart;
+            uint64_t traceIntervalFaults;
+            // Published for watchdogs: the start of the execution in progress, 0 while idle.
+            std::atomic<Clock::rep> runStart;
+            std::atomic<uint64_t> runThread;
+            // The start of the execution in progress while its timeout is unclaimed, its complement
+            // once a watchdog claimed it, 0 after End().
+            std::atomic<Clock::rep> timeoutClaim;
+#if CONCURRENCY_HAS_COROUTINES
+            IAsyncScheduledWorker* const asyncWorker;
+            Task<void> pending;
+#endif
+        };
+
+        /**
+         * @brief The hot part of a job record, the timer entry read by the dispatch thread.
+         *
+         * The entry is itself the ITask submitted to the pool, so dispatching it never allocates.
+         * Entries are cache-line aligned, so pool threads finishing neighbouring jobs of a block do
+         * not invalidate each other's dispatch state.
+         */
+        class alignas(64) PooledJob : public ITask
+        {
+        public:
+            /**
+             * @brief The outcome of a due deadline of the job.
+             */
+            enum class Dispatch : int
+            {
+                /**
+                 * @brief The job was claimed and must be submitted to the pool.
+                 */
+                Claimed,
+                /**
+                 * @brief The execution was skipped by the catch-up policy, the job stays scheduled.
+                 */
+                Skipped,
+                /**
+                 * @brief The job is executing or detached and leaves the deadline queue.
+                 */
+                Dropped
+            };
+
+            PooledJob(JobBlock& block, PooledScheduler& owner, JobExecutor& executor, ThreadPool& pool,
+                      Microsecond interval, TimingMode timing, CatchUpPolicy catchUp, TaskPriority priority,
+                      bool triggered);
+
+            /**
+             * @brief Adds a reference to the job.
+             */
+            void AddRef() noexcept;
+
+            /**
+             * @brief Drops a reference to the job, the last one releases its share of the block.
+             */
+            void Release() noexcept;
+
+            /**
+             * @brief Claims the job for execution.
+             *
+             * Only called from the dispatch thread once the deadline of the job has passed. A job
+             * that is still executing is flagged instead, and is handed back to the scheduler as
+             * soon as the running execution completes. A job dispatched a whole interval or more
+             * late applies its catch-up policy.
+             *
+             * @param deadline The deadline the job was due at.
+             * @param now The current time.
+             * @return Dispatch Whether the job was claimed, skipped to its next slot or dropped.
+             */
+            Dispatch TryDispatch(const Clock::time_point& deadline, const Clock::time_point& now);
+
+            /**
+             * @brief Submits the claimed job to the pool it is placed on.
+             *
+             * @param self The owning reference to this job, held until the execution completes.
+             */
+            void Submit(const Item& self);
+
+            /**
+             * @brief Flags the job as detached, and waits for a running execution to complete
+             * unless called from a pool thread.
+             */
+            void Detach();
+
+            /**
+             * @brief Checks whether the job was detached.
+             */
+            bool IsDetached() const;
+
+            /**
+             * @brief Keeps Detach() from returning until Unpin(), so the hosted worker stays valid.
+             *
+             * @return false if the job was detached already, in which case it is not pinned.
+             */
+            bool Pin();
+
+            /**
+             * @brief Releases a pin taken by Pin().
+             */
+            void Unpin();
+
+            /**
+             * @brief Gets the worker hosted by the job.
+             */
+            IScheduledWorker& GetWorker() const;
+
+            /**
+             * @brief Gets the pool the job is executed on.
+             */
+            ThreadPool& GetPool() const;
+
+            /**
+             * @brief Gets the statistics published after the last execution. Safe to call from any thread.
+             */
+            RoutineTimeSnapshot GetStatistics() const;
+
+            /**
+             * @brief Gets the number of executions that threw. Safe to call from any thread.
+             */
+            uint32_t GetErrorCount() const;
+
+            /**
+             * @brief Gets the execution in progress. Safe to call from any thread.
+             */
+            bool GetRunning(Clock::time_point& since, uint64_t& threadId) const;
+
+            /**
+             * @brief Takes over notifying the worker of the timeout of an execution, see
+             * JobExecutor::ClaimTimeout().
+             */
+            bool ClaimTimeout(const Clock::time_point& since);
+
+            /**
+             * @brief Gets the expected duration of one execution in milliseconds, 0 if it has none.
+             */
+            Millisecond GetDurationLimit() const;
+
+            /**
+             * @brief Gets the time monitor of the job, for reading its histograms from any thread.
+             */
+            const PublishedRoutineTimeMonitor& GetMonitor() const;
+
+            /**
+             * @brief Gets the deadline following the last dispatched execution.
+             *
+             * Relative jobs are due one interval after the last dispatch, fixed-rate jobs one
+             * interval after the deadline that dispatch was due at. A job that fell a whole
+             * interval or more behind continues as decided by its catch-up policy. A periodic job
+             * with an interval of 0 is due again at once, so it runs back to back. A triggered job
+             * without a timeout only runs when notified and has no next deadline.
+             */
+            Clock::time_point GetNextDeadline() const;
+
+            /**
+             * @brief Runs the hosted worker once on the calling pool thread.
+             *
+             * An asynchronous worker only runs up to its first suspension, the execution completes
+             * on the thread resuming it.
+             *
+             * @return false, a job is submitted again by the dispatch thread only.
+             */
+            bool Run() override;
+
+            /**
+             * @brief Ends a claimed execution: marks the job idle and hands it back if it was missed meanwhile.
+             *
+             * @param self The owning reference to this job.
+             */
+            void Complete(const Item& self);
+
+            /**
+             * @brief Drops a claimed execution that was not started in time, counting an interval fault.
+             *
+             * Only called from the dispatch thread.
+             *
+             * @param self The owning reference to this job.
+             */
+            void Skip(const Item& self);
+
+            /**
+             * @brief Checks whether the hosted worker runs as a coroutine.
+             */
+            bool IsAsync() const;
+
+            /**
+             * @brief Gets the priority requested for the job.
+             */
+            TaskPriority GetPriority() const;
+
+            /**
+             * @brief Gets the interval between the executions of the job.
+             */
+            std::chrono::microseconds GetInterval() const;
+
+            /**
+             * @brief Gets the deadline the claimed execution should complete by, the deadline it was
+             * due at plus one interval.
+             */
+            const Clock::time_point& GetReleaseDeadline() const;
+
+            /**
+             * @brief Flags the claimed execution as occupying a pool thread rationed by the dispatch policy.
+             */
+            void SetRationed();
+
+            /**
+             * @brief Links of the lock-free inbox, in which a job is queued at most once at a time.
+             */
+            Item inboxSelf;
+            PooledJob* inboxNext;
+            Clock::time_point inboxDeadline;
+
+            /**
+             * @brief Links of the lock-free wake list, in which a job is queued at most once at a
+             * time while wakeRequested is set.
+             */
+            Item wakeSelf;
+            PooledJob* wakeNext;
+            std::atomic<bool> wakeRequested;
+
+            /**
+             * @brief Set by the dispatch thread when it queues the job for a wake, cleared when an
+             * execution is claimed. A missed execution finding it set is re-posted at once.
+             */
+            std::atomic<bool> woken;
+
+            static constexpr std::size_t NOT_QUEUED = ~static_cast<std::size_t>(0);
+
+            /**
+             * @brief The index of the one entry of the job in the deadline queue, NOT_QUEUED if it
+             * has none. Only used by the dispatch thread.
+             */
+            std::size_t queueIndex;
+
+        private:
+            enum DispatchState : uint32_t
+            {
+                Idle,
+                Running,
+                RunningMissed
+            };
+
+#if CONCURRENCY_HAS_COROUTINES
+            static void CompleteAsync(void* context);
+#endif
+
+            Clock::time_point CatchUp(const Clock::time_point& now);
+            void NotifyIdle();
+
+            std::atomic<uint32_t> state;
+            std::atomic<bool> detached;
+            std::atomic<uint32_t> pins;
+            std::atomic<uint32_t> refCount;
+            const std::chrono::microseconds interval;
+            const TimingMode timing;
+            const CatchUpPolicy catchUp;
+            const TaskPriority priority;
+            const bool triggered;
+            Clock::time_point last;
+            Clock::time_point releaseDeadline;
+            bool rationed;
+            PooledScheduler* owner;
+            JobBlock* block;
+            JobExecutor* executor;
+            ThreadPool* pool;
+            Item runSelf;
+        };
+
+        /**
+         * @brief Contiguous storage for the records of the jobs attached together.
+         *
+         * The block header, the hot dispatch entries of its jobs, their cold executors and their
+         * agents live as separate contiguous arrays in a single allocation from a memory resource,
+         * so walking the entries of a block never touches the statistics. Each array holds whole
+         * records: this is a hot/cold split, not one array per field. Every live job holds one
+         * reference to the block, so the block is returned to the resource once the last of its
+         * jobs has been detached and released by the dispatch thread and the pool.
+         */
+        class JobBlock
+        {
+        public:
+            /**
+             * @brief Allocates a block with room for a number of jobs and agents.
+             *
+             * @param resource The memory resource to allocate the block from.
+             * @param capacity The maximum number of jobs and of agents in the block.
+             * @return JobBlock* The new block, holding no reference yet.
+             */
+            static JobBlock* Create(std::pmr::memory_resource& resource, std::size_t capacity);
+
+            JobBlock(const JobBlock&) = delete;
+            JobBlock& operator=(const JobBlock&) = delete;
+
+            void AddRef() noexcept;
+            void Release() noexcept;
+
+            ActionWorker& AddAgent(const char* name, ActionStorage action, CallbackStorage callback);
+            PooledJob& AddJob(PooledScheduler& owner, IScheduledWorker& hostWorker, ThreadPool& pool,
+                              Microsecond interval, TimingMode timing, CatchUpPolicy catchUp,
+                              TaskPriority priority, Millisecond duration, bool latencyHistograms,
+                              bool cpuAccounting, bool triggered);
+
+        private:
+            JobBlock(std::pmr::memory_resource& resource, std::size_t capacity);
+            ~JobBlock();
+
+            static std::size_t AlignUp(std::size_t size, std::size_t alignment);
+            static std::size_t JobsOffset();
+            static std::size_t ExecutorsOffset(std::size_t capacity);
+            static std::size_t AgentsOffset(std::size_t capacity);
+            static std::size_t AllocationSize(std::size_t capacity);
+            static std::size_t AllocationAlignment();
+
+            std::pmr::memory_resource* const resource;
+            const std::size_t capacity;
+            std::atomic<uint32_t> refCount;
+            PooledJob* const jobs;
+            JobExecutor* const executors;
+            std::size_t jobCount;
+            ActionWorker* const agents;
+            std::size_t agentCount;
+        };
+
+        /**
+         * @brief A due job waiting for a pool thread under a rationing dispatch policy.
+         */
+        struct ReadyEntry
+        {
+            Clock::time_point deadline;
+            std::chrono::microseconds interval;
+            TaskPriority priority;
+            Item job;
+        };
+
+        /**
+         * @brief Orders the ready heap so that its front is the entry to run next.
+         *
+         * Rate monotonic entries are ordered by interval first. Within that, the earlier deadline
+         * goes first, and equal deadlines go to the higher priority.
+         */
+        struct ReadyOrder
+        {
+            bool operator()(const ReadyEntry& left, const ReadyEntry& right) const
+            {
+                if (rateMonotonic && left.interval != right.interval)
+                {
+                    return left.interval > right.interval;
+                }
+                if (left.deadline != right.deadline)
+                {
+                    return left.deadline > right.deadline;
+                }
+                return left.priority < right.priority;
+            }
+
+            bool rateMonotonic;
+        };
+
+        static PooledJob*& CurrentJob();
+        static const PooledJob*& PinnedJob();
+
+        template <typename Storage, typename Callable>
+        static Storage Store(Callable& callable);
+
+        Item AddJobs(JobSpec* specs, std::size_t count);
+        ThreadPool& PlacePool(const ThreadPlacement& placement);
+        void AddActionJob(const char* name, ActionStorage action, CallbackStorage callback, Millisecond interval,
+                          TaskPriority priority);
+        std::shared_ptr<ScheduleContainer> MakeContainer() const;
+        void Publish(ScheduleContainer& added);
+        template <typename Predicate>
+        bool DetachIf(Predicate predicate);
+        template <typename Predicate>
+        Item FindJob(Predicate predicate) const;
+        Item FindJobByName(const char* name) const;
+        void Post(Item job, const Clock::time_point& deadline);
+        void Post(PooledJob* first, PooledJob* last);
+        void DrainInbox();
+        void Schedule(Item job, const Clock::time_point& deadline);
+        bool WakeJob(const Item& job);
+        void PostWake(const Item& job);
+        void DrainWakes();
+        bool HasPosts() const;
+        bool IsStopped() const;
+        bool IsOwnThread();
+        void Release(const Item& job);
+        void FeedPool();
+        bool CanFeed() const;
+        bool IsShed(const PooledJob& job) const;
+        void EndRationedRun();
+#if CONCURRENCY_HAS_COROUTINES
+        void PostTimer(TimerAwaiter& timer);
+        void DrainTimers();
+        void EndAsyncRun();
+#endif
+
+        std::pmr::synchronized_pool_resource ownedResource;
+        std::pmr::memory_resource* const resource;
+        const TaskPriority workerTaskPriority;
+        ThreadPool pool;
+        std::vector<std::unique_ptr<ThreadPool>> lanes;
+        // Guards lanes and lanesActive apart from activationMutex, which Deactivate() holds while
+        // the jobs that may place themselves on a new lane complete.
+        std::mutex lanesMutex;
+        bool lanesActive;
+        std::thread thread;
+        std::atomic<bool> terminated;
+        bool active;
+        AtomicSharedPtr<const ScheduleContainer> workers;
+        std::mutex workersMutex;
+        DeadlineQueue<Item, Clock, QueuePosition> deadlines;
+        std::atomic<PooledJob*> inbox;
+        std::atomic<PooledJob*> wakeInbox;
+#if CONCURRENCY_HAS_COROUTINES
+        DeadlineQueue<TimerAwaiter*, Clock> timers;
+        std::atomic<TimerAwaiter*> timerInbox;
+#endif
+        std::atomic<uint32_t> asyncRuns;
+        std::atomic<bool> sleeping;
+        std::mutex wakeMutex;
+        std::condition_variable cond;
+        std::mutex activationMutex;
+        std::mutex detachMutex;
+        std::condition_variable detachCond;
+        DispatchTiming dispatchTiming;
+        HighResolutionTimer timer;
+        DispatchPolicy dispatchPolicy;
+        OverloadPolicy overloadPolicy;
+        TaskPriority shedPriority;
+        std::vector<ReadyEntry> ready;
+        std::atomic<uint32_t> rationedRuns;
+        std::atomic<bool> readyWaiting;
+    };
+
+    /**
+     * @brief Handle notifying a job of a PooledScheduler, see PooledScheduler::AttachTriggered().
+     *
+     * Holds the job itself, so notifying never looks the job up. Copies notify the same job. A
+     * handle may outlive the detachment of its job, after which it notifies nothing, but not the
+     * scheduler.
+     */
+    class PooledScheduler::Trigger
+    {
+    public:
+        /**
+         * @brief Construct an empty handle notifying nothing.
+         */
+        Trigger() : owner(nullptr)
+        {
+        }
+
+        /**
+         * @brief Runs the job as soon as possible. Safe from any thread, lock-free.
+         *
+         * @return true if the job is still attached.
+         */
+        bool Notify() const
+        {
+            return job && owner->WakeJob(job);
+        }
+
+        /**
+         * @brief Checks whether the handle refers to a job.
+         */
+        explicit operator bool() const
+        {
+            return static_cast<bool>(job);
+        }
+
+    private:
+        friend class PooledScheduler;
+
+        Trigger(PooledScheduler& owner, Item job) : owner(&owner), job(std::move(job))
+        {
+        }
+
+        PooledScheduler* owner;
+        Item job;
+    };
+
+#if CONCURRENCY_HAS_COROUTINES
+    /**
+     * @brief Awaitable resuming the awaiting coroutine on a pool thread once a deadline has passed.
+     *
+     * Lives in the frame of the suspended coroutine and is queued intrusively, so a delay never allocates.
+     */
+    class PooledScheduler::TimerAwaiter : public ITask
+    {
+    public:
+        TimerAwaiter(PooledScheduler& owner, Clock::time_point deadline);
+
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept;
+
+        /**
+         * @brief Resumes the coroutine on the calling pool thread.
+         */
+        bool Run() override;
+
+    private:
+        friend class PooledScheduler;
+
+        PooledScheduler* owner;
+        Clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        PooledJob* job;
+        TimerAwaiter* next;
+    };
+
+    /**
+     * @brief Awaitable resuming the awaiting coroutine on a pool thread as soon as one is free.
+     */
+    class PooledScheduler::PoolAwaiter : public ITask
+    {
+    public:
+        explicit PoolAwaiter(PooledScheduler& owner);
+
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept;
+
+        /**
+         * @brief Resumes the coroutine on the calling pool thread.
+         */
+        bool Run() override;
+
+    private:
+        PooledScheduler* owner;
+        std::coroutine_handle<> handle;
+        PooledJob* job;
+    };
+#endif
+
+    inline PooledScheduler::ActionWorker::ActionWorker(const char* name, ActionStorage action, CallbackStorage callback)
+        : name(name == nullptr ? "" : name), action(std::move(action)), callback(std::move(callback))
+    {
+    }
+
+    inline void PooledScheduler::ActionWorker::RunOnce()
+    {
+        if (action)
+        {
+            action();
+        }
+    }
+
+    inline const char* PooledScheduler::ActionWorker::GetWorkerName() const
+    {
+        return name.c_str();
+    }
+
+    inline void PooledScheduler::ActionWorker::NotifyDurationTimeout(const bool& isTimeout) const
+    {
+        if (callback)
+        {
+            callback(isTimeout);
+        }
+    }
+
+    inline PooledScheduler::JobExecutor::JobExecutor(IScheduledWorker& hostWorker, Microsecond interval,
+                                                     Millisecond duration, bool latencyHistograms,
+                                                     bool cpuAccounting)
+        : hostWorker(&hostWorker),
+          durationMax(duration),
+          executionErrorsCnt(0),
+          timeMonitor(duration * MicrosecondInMillisecond, interval),
+          scheduledCount(0),
+          msgCnt(0),
+          traceId(0),
+          tracing(false),
+          traceStart(0),
+          traceIntervalFaults(0),
+          runStart(0),
+          runThread(0),
+          timeoutClaim(0)
+#if CONCURRENCY_HAS_COROUTINES
+          ,
+          asyncWorker(dynamic_cast<IAsyncScheduledWorker*>(&hostWorker))
+#endif
+    {
+        if (latencyHistograms)
+        {
+            timeMonitor.EnableHistograms();
+        }
+        if (cpuAccounting)
+        {
+            timeMonitor.EnableCpuAccounting();
+        }
+    }
+
+    inline void PooledScheduler::JobExecutor::RunOnce()
+    {
+        Begin();
+        try
+        {
+            hostWorker->RunOnce();
+        }
+        catch (...)
+        {
+            HandleFailure();
+        }
+        End();
+    }
+
+#if CONCURRENCY_HAS_COROUTINES
+    inline bool PooledScheduler::JobExecutor::IsAsync() const
+    {
+        return asyncWorker != nullptr;
+    }
+
+    inline void PooledScheduler::JobExecutor::StartAsync(TaskPromiseBase::Completion completion, void* context)
+    {
+        Begin();
+        try
+        {
+            pending = asyncWorker->RunOnceAsync();
+        }
+        catch (...)
+        {
+            HandleFailure();
+        }
+        if (!pending)
+        {
+            completion(context);
+            return;
+        }
+        pending.Start(completion, context);
+    }
+
+    inline void PooledScheduler::JobExecutor::FinishAsync()
+    {
+        Task<void> finished = std::move(pending);
+        if (finished)
+        {
+            try
+            {
+                finished.GetResult();
+            }
+            catch (...)
+            {
+                HandleFailure();
+            }
+        }
+        End();
+    }
+#endif
+
+    inline void PooledScheduler::JobExecutor::Begin()
+    {
+        tracing = TraceRecorder::IsEnabled();
+        if (tracing)
+        {
+            traceStart = TraceRecorder::Now();
+            traceIntervalFaults = timeMonitor.GetIntervalFaultCount();
+        }
+        const Clock::rep start = Clock::now().time_since_epoch().count();
+        runThread.store(ThisThread::GetId(), std::memory_order_relaxed);
+        timeoutClaim.store(start, std::memory_order_relaxed);
+        runStart.store(start, std::memory_order_release);
+        timeMonitor.Start();
+    }
+
+    inline void PooledScheduler::JobExecutor::End()
+    {
+        timeMonitor.Stop();
+        const Clock::rep start = runStart.load(std::memory_order_relaxed);
+        const bool claimed = timeoutClaim.exchange(0) == ~start;
+        runStart.store(0, std::memory_order_release);
+        ++scheduledCount;
+
+        bool isTimeout = false;
+        if (durationMax > 0)
+        {
+            isTimeout = timeMonitor.GetCurrentDuration() > durationMax * MicrosecondInMillisecond;
+            if (isTimeout && msgCnt++ % DURATION_MSG_INTERVAL == 0)
+            {
+                LogFilter::Format<LogLevel::Warning>("worker %s duration timeout, expected %llu ms, actual is %llu us",
+                                                     hostWorker->GetWorkerName(),
+                                                     static_cast<unsigned long long>(durationMax),
+                                                     static_cast<unsigned long long>(timeMonitor.GetCurrentDuration()));
+            }
+            if (!isTimeout || !claimed)
+            {
+                // A watchdog that claimed the timeout has notified the worker already.
+                hostWorker->NotifyDurationTimeout(isTimeout);
+            }
+        }
+        if (tracing)
+        {
+            Trace(isTimeout);
+        }
+    }
+
+    inline void PooledScheduler::JobExecutor::HandleFailure()
+    {
+        executionErrorsCnt.fetch_add(1, std::memory_order_relaxed);
+        try
+        {
+            throw;
+        }
+        catch (const std::exception& e)
+        {
+            LogFilter::Format<LogLevel::Error>("worker %s execution failed: %s", hostWorker->GetWorkerName(), e.what());
+        }
+        catch (...)
+        {
+            LogFilter::Format<LogLevel::Error>("worker %s execution failed with an unknown exception",
+                                               hostWorker->GetWorkerName());
+        }
+    }
+
+    inline IScheduledWorker& PooledScheduler::JobExecutor::GetWorker() const
+    {
+        return *hostWorker;
+    }
+
+    inline RoutineTimeSnapshot PooledScheduler::JobExecutor::GetStatistics() const
+    {
+        return timeMonitor.Snapshot();
+    }
+
+    inline uint32_t PooledScheduler::JobExecutor::GetErrorCount() const
+    {
+        return executionErrorsCnt.load(std::memory_order_relaxed);
+    }
+
+    inline bool PooledScheduler::JobExecutor::GetRunning(Clock::time_point& since, uint64_t& threadId) const
+    {
+        const Clock::rep start = runStart.load(std::memory_order_acquire);
+        if (start == 0)
+        {
+            return false;
+        }
+        threadId = runThread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (runStart.load(std::memory_order_relaxed) != start)
+        {
+            // The execution ended, or another one started, while being read.
+            return false;
+        }
+        since = Clock::time_point(Clock::duration(start));
+        return true;
+    }
+
+    inline bool PooledScheduler::JobExecutor::ClaimTimeout(const Clock::time_point& since)
+    {
+        // Fails once End() has reset the claim, and for any execution but the one started at since.
+        Clock::rep expected = since.time_since_epoch().count();
+        return timeoutClaim.compare_exchange_strong(expected, ~expected);
+    }
+
+    inline Millisecond PooledScheduler::JobExecutor::GetDurationLimit() const
+    {
+        return durationMax;
+    }
+
+    inline const PublishedRoutineTimeMonitor& PooledScheduler::JobExecutor::GetMonitor() const
+    {
+        return timeMonitor;
+    }
+
+    inline void PooledScheduler::JobExecutor::TraceMissed()
+    {
+        TraceRecorder::GetInstance().Record(TraceEventType::Missed, GetTraceId(), TraceRecorder::Now());
+    }
+
+    inline void PooledScheduler::JobExecutor::Skip()
+    {
+        timeMonitor.IncrementIntervalFaultCount();
+        if (TraceRecorder::IsEnabled())
+        {
+            TraceRecorder::GetInstance().Record(TraceEventType::Skipped, GetTraceId(), TraceRecorder::Now());
+        }
+    }
+
+    inline uint32_t PooledScheduler::JobExecutor::GetTraceId()
+    {
+        if (traceId == 0)
+        {
+            traceId = TraceRecorder::GetInstance().RegisterJob(hostWorker->GetWorkerName());
+        }
+        return traceId;
+    }
+
+    inline void PooledScheduler::JobExecutor::Trace(bool isTimeout)
+    {
+        TraceRecorder& recorder = TraceRecorder::GetInstance();
+        const uint64_t stop = TraceRecorder::Now();
+        const uint32_t id = GetTraceId();
+        recorder.Record(TraceEventType::Run, id, traceStart, stop - traceStart);
+        if (isTimeout)
+        {
+            recorder.Record(TraceEventType::DurationOverrun, id, stop);
+        }
+        if (timeMonitor.GetIntervalFaultCount() != traceIntervalFaults)
+        {
+            recorder.Record(TraceEventType::IntervalFault, id, traceStart);
+        }
+    }
+
+    inline PooledScheduler::PooledJob::PooledJob(JobBlock& block, PooledScheduler& owner, JobExecutor& executor,
+                                                 ThreadPool& pool, Microsecond interval, TimingMode timing,
+                                                 CatchUpPolicy catchUp, TaskPriority priority, bool triggered)
+        : inboxNext(nullptr),
+          wakeNext(nullptr),
+          wakeRequested(false),
+          woken(false),
+          queueIndex(NOT_QUEUED),
+          state(Idle),
+          detached(false),
+          pins(0),
+          refCount(0),
+          interval(interval),
+          timing(timing),
+          catchUp(catchUp),
+          priority(priority),
+          triggered(triggered),
+          rationed(false),
+          owner(&owner),
+          block(&block),
+          executor(&executor),
+          pool(&pool)
+    {
+        block.AddRef();
+    }
+
+    inline void PooledScheduler::PooledJob::AddRef() noexcept
+    {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void PooledScheduler::PooledJob::Release() noexcept
+    {
+        if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            block->Release();
+        }
+    }
+
+    inline PooledScheduler::PooledJob::Dispatch PooledScheduler::PooledJob::TryDispatch(
+        const Clock::time_point& deadline, const Clock::time_point& now)
+    {
+        uint32_t current = state.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const uint32_t desired = current == Idle ? Running : RunningMissed;
+            if (state.compare_exchange_weak(current, desired, std::memory_order_acq_rel))
+            {
+                break;
+            }
+        }
+        if (current != Idle)
+        {
+            return Dispatch::Dropped;
+        }
+        if (detached.load())
+        {
+            state.store(Idle);
+            NotifyIdle();
+            return Dispatch::Dropped;
+        }
+        const Clock::duration lateness = now - deadline;
+        if (lateness < interval || interval.count() == 0)
+        {
+            last = timing == TimingMode::FixedRate ? deadline : now;
+        }
+        else if (catchUp == CatchUpPolicy::FireAll)
+        {
+            last = deadline;
+        }
+        else
+        {
+            // The latest slot that has passed, so the next deadline is the first one ahead.
+            const Clock::time_point slot = deadline + interval * (lateness / interval);
+            if (catchUp == CatchUpPolicy::SkipToNext)
+            {
+                last = slot;
+                executor->Skip();
+                state.store(Idle);
+                NotifyIdle();
+                return Dispatch::Skipped;
+            }
+            last = timing == TimingMode::FixedRate ? slot : now;
+        }
+        releaseDeadline = deadline + interval;
+        woken.store(false);
+        return Dispatch::Claimed;
+    }
+
+    inline void PooledScheduler::PooledJob::Detach()
+    {
+        detached.store(true);
+        if (CurrentJob() == this || ThreadPool::GetCurrent() != nullptr)
+        {
+            // The execution may be queued behind the calling pool thread, Run() discards it.
+            return;
+        }
+        // A visitor of CollectRunning() detaching the job it visits holds one of the pins itself.
+        const uint32_t ownPins = PinnedJob() == this ? 1 : 0;
+        std::unique_lock<std::mutex> lock(owner->detachMutex);
+        owner->detachCond.wait(lock, [this, ownPins]() { return state.load() == Idle && pins.load() == ownPins; });
+    }
+
+    inline bool PooledScheduler::PooledJob::Pin()
+    {
+        pins.fetch_add(1);
+        // Pairs with Detach(): either it waits for the pin, or the pin sees the job detached.
+        if (detached.load())
+        {
+            Unpin();
+            return false;
+        }
+        return true;
+    }
+
+    inline void PooledScheduler::PooledJob::Unpin()
+    {
+        if (pins.fetch_sub(1) == 1)
+        {
+            NotifyIdle();
+        }
+    }
+
+    inline void PooledScheduler::PooledJob::NotifyIdle()
+    {
+        // Pairs with Detach(): either it sees the job idle, or the job sees it detached.
+        if (detached.load())
+        {
+            std::lock_guard<std::mutex> lock(owner->detachMutex);
+            owner->detachCond.notify_all();
+        }
+    }
+
+    inline bool PooledScheduler::PooledJob::IsDetached() const
+    {
+        return detached.load();
+    }
+
+    inline IScheduledWorker& PooledScheduler::PooledJob::GetWorker() const
+    {
+        return executor->GetWorker();
+    }
+
+    inline ThreadPool& PooledScheduler::PooledJob::GetPool() const
+    {
+        return *pool;
+    }
+
+    inline RoutineTimeSnapshot PooledScheduler::PooledJob::GetStatistics() const
+    {
+        return executor->GetStatistics();
+    }
+
+    inline uint32_t PooledScheduler::PooledJob::GetErrorCount() const
+    {
+        return executor->GetErrorCount();
+    }
+
+    inline bool PooledScheduler::PooledJob::GetRunning(Clock::time_point& since, uint64_t& threadId) const
+    {
+        return executor->GetRunning(since, threadId);
+    }
+
+    inline bool PooledScheduler::PooledJob::ClaimTimeout(const Clock::time_point& since)
+    {
+        return executor->ClaimTimeout(since);
+    }
+
+    inline Millisecond PooledScheduler::PooledJob::GetDurationLimit() const
+    {
+        return executor->GetDurationLimit();
+    }
+
+    inline const PublishedRoutineTimeMonitor& PooledScheduler::PooledJob::GetMonitor() const
+    {
+        return executor->GetMonitor();
+    }
+
+    inline PooledScheduler::Clock::time_point PooledScheduler::PooledJob::GetNextDeadline() const
+    {
+        return triggered && interval.count() == 0 ? (Clock::time_point::max)() : last + interval;
+    }
+
+    inline void PooledScheduler::PooledJob::Submit(const Item& self)
+    {
+        runSelf = self;
+        pool->Submit(*this);
+    }
+
+    inline bool PooledScheduler::PooledJob::Run()
+    {
+        if (detached.load())
+        {
+            // Detached from a pool thread after it was dispatched.
+            const Item self = std::move(runSelf);
+            Complete(self);
+            return false;
+        }
+#if CONCURRENCY_HAS_COROUTINES
+        if (executor->IsAsync())
+        {
+            owner->asyncRuns.fetch_add(1);
+            CurrentJob() = this;
+            executor->StartAsync(&PooledJob::CompleteAsync, this);
+            CurrentJob() = nullptr;
+            return false;
+        }
+#endif
+        const Item self = std::move(runSelf);
+        CurrentJob() = this;
+        executor->RunOnce();
+        CurrentJob() = nullptr;
+        Complete(self);
+        return false;
+    }
+
+#if CONCURRENCY_HAS_COROUTINES
+    inline void PooledScheduler::PooledJob::CompleteAsync(void* context)
+    {
+        PooledJob& job = *static_cast<PooledJob*>(context);
+        PooledScheduler& owner = *job.owner;
+        job.executor->FinishAsync();
+        {
+            const Item self = std::move(job.runSelf);
+            job.Complete(self);
+        }
+        owner.EndAsyncRun();
+    }
+#endif
+
+    inline void PooledScheduler::PooledJob::Complete(const Item& self)
+    {
+        if (rationed)
+        {
+            rationed = false;
+            owner->EndRationedRun();
+        }
+        uint32_t current = Running;
+        if (state.compare_exchange_strong(current, Idle))
+        {
+            NotifyIdle();
+            return;
+        }
+        // Missed meanwhile. Only the completing thread leaves this state, so the job stays owned
+        // until it is marked idle below.
+        if (TraceRecorder::IsEnabled())
+        {
+            executor->TraceMissed();
+        }
+        const bool repost = !detached.load();
+        Clock::time_point deadline;
+        if (repost)
+        {
+            const Clock::time_point now = Clock::now();
+            deadline = CatchUp(now);
+            if (woken.exchange(false) && now < deadline)
+            {
+                // A wake missed while the execution overran still runs the job right away.
+                deadline = now;
+            }
+        }
+        state.store(Idle);
+        if (repost)
+        {
+            owner->Post(self, deadline);
+        }
+        NotifyIdle();
+    }
+
+    inline PooledScheduler::Clock::time_point PooledScheduler::PooledJob::CatchUp(const Clock::time_point& now)
+    {
+        const Clock::time_point first = last + interval;
+        if (now < first || interval.count() == 0)
+        {
+            // Missed because of a wake, not of lateness.
+            return now;
+        }
+        if (catchUp == CatchUpPolicy::FireAll)
+        {
+            return first;
+        }
+        // The missed slots become the latest one that has passed, or are dropped for the next one.
+        const Clock::time_point slot = first + interval * ((now - first) / interval);
+        if (catchUp == CatchUpPolicy::SkipToNext)
+        {
+            executor->Skip();
+            return slot + interval;
+        }
+        return slot;
+    }
+
+    inline void PooledScheduler::PooledJob::Skip(const Item& self)
+    {
+        executor->Skip();
+        Complete(self);
+    }
+
+    inline bool PooledScheduler::PooledJob::IsAsync() const
+    {
+#if CONCURRENCY_HAS_COROUTINES
+        return executor->IsAsync();
+#else
+        return false;
+#endif
+    }
+
+    inline TaskPriority PooledScheduler::PooledJob::GetPriority() const
+    {
+        return priority;
+    }
+
+    inline std::chrono::microseconds PooledScheduler::PooledJob::GetInterval() const
+    {
+        return interval;
+    }
+
+    inline const PooledScheduler::Clock::time_point& PooledScheduler::PooledJob::GetReleaseDeadline() const
+    {
+        return releaseDeadline;
+    }
+
+    inline void PooledScheduler::PooledJob::SetRationed()
+    {
+        rationed = true;
+    }
+
+    inline PooledScheduler::JobBlock* PooledScheduler::JobBlock::Create(std::pmr::memory_resource& resource,
+                                                                        std::size_t capacity)
+    {
+        void* storage = resource.allocate(AllocationSize(capacity), AllocationAlignment());
+        return new (storage) JobBlock(resource, capacity);
+    }
+
+    inline PooledScheduler::JobBlock::JobBlock(std::pmr::memory_resource& resource, std::size_t capacity)
+        : resource(&resource),
+          capacity(capacity),
+          refCount(0),
+          jobs(reinterpret_cast<PooledJob*>(reinterpret_cast<unsigned char*>(this) + JobsOffset())),
+          executors(reinterpret_cast<JobExecutor*>(reinterpret_cast<unsigned char*>(this) + ExecutorsOffset(capacity))),
+          jobCount(0),
+          agents(reinterpret_cast<ActionWorker*>(reinterpret_cast<unsigned char*>(this) + AgentsOffset(capacity))),
+          agentCount(0)
+    {
+    }
+
+    inline PooledScheduler::JobBlock::~JobBlock()
+    {
+        while (jobCount > 0)
+        {
+            --jobCount;
+            jobs[jobCount].~PooledJob();
+            executors[jobCount].~JobExecutor();
+        }
+        while (agentCount > 0)
+        {
+            agents[--agentCount].~ActionWorker();
+        }
+    }
+
+    inline void PooledScheduler::JobBlock::AddRef() noexcept
+    {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void PooledScheduler::JobBlock::Release() noexcept
+    {
+        if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::pmr::memory_resource* const owner = resource;
+            const std::size_t size = AllocationSize(capacity);
+            this->~JobBlock();
+            owner->deallocate(this, size, AllocationAlignment());
+        }
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::AlignUp(std::size_t size, std::size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::JobsOffset()
+    {
+        return AlignUp(sizeof(JobBlock), alignof(PooledJob));
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::ExecutorsOffset(std::size_t capacity)
+    {
+        return AlignUp(JobsOffset() + capacity * sizeof(PooledJob), alignof(JobExecutor));
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::AgentsOffset(std::size_t capacity)
+    {
+        return AlignUp(ExecutorsOffset(capacity) + capacity * sizeof(JobExecutor), alignof(ActionWorker));
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::AllocationSize(std::size_t capacity)
+    {
+        return AgentsOffset(capacity) + capacity * sizeof(ActionWorker);
+    }
+
+    inline std::size_t PooledScheduler::JobBlock::AllocationAlignment()
+    {
+        return (std::max)({alignof(JobBlock), alignof(PooledJob), alignof(JobExecutor), alignof(ActionWorker)});
+    }
+
+    inline PooledScheduler::ActionWorker& PooledScheduler::JobBlock::AddAgent(const char* name, ActionStorage action,
+                                                                              CallbackStorage callback)
+    {
+        ActionWorker* agent = new (&agents[agentCount]) ActionWorker(name, std::move(action), std::move(callback));
+        ++agentCount;
+        return *agent;
+    }
+
+    inline PooledScheduler::PooledJob& PooledScheduler::JobBlock::AddJob(PooledScheduler& owner,
+                                                                         IScheduledWorker& hostWorker, ThreadPool& pool,
+                                                                         Microsecond interval, TimingMode timing,
+                                                                         CatchUpPolicy catchUp, TaskPriority priority,
+                                                                         Millisecond duration, bool latencyHistograms,
+                                                                         bool cpuAccounting, bool triggered)
+    {
+        JobExecutor* executor = new (&executors[jobCount])
+            JobExecutor(hostWorker, interval, duration, latencyHistograms, cpuAccounting);
+        PooledJob* job =
+            new (&jobs[jobCount]) PooledJob(*this, owner, *executor, pool, interval, timing, catchUp, priority, triggered);
+        ++jobCount;
+        return *job;
+    }
+
+    inline PooledScheduler::PooledScheduler(TaskPriority workerTaskPriority, uint32_t poolSize,
+                                            std::pmr::memory_resource* resource)
+        : resource(resource == nullptr ? &ownedResource : resource),
+          workerTaskPriority(workerTaskPriority),
+          pool(poolSize, workerTaskPriority, "PooledScheduler"),
+          lanesActive(false),
+          terminated(false),
+          active(false),
+          workers(std::make_shared<const ScheduleContainer>()),
+          inbox(nullptr),
+          wakeInbox(nullptr),
+#if CONCURRENCY_HAS_COROUTINES
+          timerInbox(nullptr),
+#endif
+          asyncRuns(0),
+          sleeping(false),
+          dispatchPolicy(DispatchPolicy::Immediate),
+          overloadPolicy(OverloadPolicy::RunLate),
+          shedPriority(0),
+          rationedRuns(0),
+          readyWaiting(false)
+    {
+    }
+
+    inline PooledScheduler::~PooledScheduler(void)
+    {
+        Deactivate();
+        PooledJob* job = inbox.exchange(nullptr);
+        while (job != nullptr)
+        {
+            PooledJob* next = job->inboxNext;
+            job->inboxSelf.Reset();
+            job = next;
+        }
+        job = wakeInbox.exchange(nullptr);
+        while (job != nullptr)
+        {
+            PooledJob* next = job->wakeNext;
+            job->wakeSelf.Reset();
+            job = next;
+        }
+    }
+
+    inline void PooledScheduler::Attach(IScheduledWorker& scheduleItem, Millisecond interval,
+                                        const TaskPriority threadPriority)
+    {
+        Attach(scheduleItem, threadPriority, interval, 0);
+    }
+
+    inline void PooledScheduler::Attach(IScheduledWorker& scheduleItem, const TaskPriority threadPriority,
+                                        Millisecond interval, Millisecond duration)
+    {
+        JobSpec spec(scheduleItem, interval, threadPriority, duration);
+        AddJobs(&spec, 1);
+    }
+
+    inline void PooledScheduler::Attach(IScheduledWorker& scheduleItem, Millisecond interval,
+                                        const TaskPriority threadPriority, const ThreadPlacement& placement)
+    {
+        JobSpec spec(scheduleItem, interval, threadPriority);
+        spec.placement = placement;
+        AddJobs(&spec, 1);
+    }
+
+    inline void PooledScheduler::Attach(IScheduledWorker& scheduleItem, std::chrono::microseconds interval,
+                                        const TaskPriority threadPriority, TimingMode timing,
+                                        CatchUpPolicy catchUp)
+    {
+        JobSpec spec(scheduleItem, 0, threadPriority);
+        spec.preciseInterval = static_cast<Microsecond>(interval.count());
+        spec.timing = timing;
+        spec.catchUp = catchUp;
+        AddJobs(&spec, 1);
+    }
+
+    inline void PooledScheduler::Attach(const char* name, Action action, Millisecond interval,
+                                        const TaskPriority threadPriority)
+    {
+        Attach(name, std::move(action), interval, threadPriority, TimeoutCallback());
+    }
+
+    inline void PooledScheduler::Attach(const char* name, Action action, Millisecond interval,
+                                        const TaskPriority threadPriority, TimeoutCallback callback)
+    {
+        JobSpec spec(name, std::move(action), interval, threadPriority, std::move(callback));
+        AddJobs(&spec, 1);
+    }
+
+    template <std::size_t Capacity, bool AllowHeap>
+    inline void PooledScheduler::Attach(const char* name, InplaceAction<Capacity, AllowHeap> action,
+                                        Millisecond interval, const TaskPriority threadPriority)
+    {
+        AddActionJob(name, std::move(action), CallbackStorage(), interval, threadPriority);
+    }
+
+    template <std::size_t Capacity, bool AllowHeap, std::size_t CallbackCapacity, bool CallbackAllowHeap>
+    inline void PooledScheduler::Attach(const char* name, InplaceAction<Capacity, AllowHeap> action,
+                                        Millisecond interval, const TaskPriority threadPriority,
+                                        InplaceTimeoutCallback<CallbackCapacity, CallbackAllowHeap> callback)
+    {
+        AddActionJob(name, std::move(action), std::move(callback), interval, threadPriority);
+    }
+
+    inline void PooledScheduler::AttachBatch(const JobSpec* specs, std::size_t count)
+    {
+        AttachBatch(std::vector<JobSpec>(specs, specs + count));
+    }
+
+    inline void PooledScheduler::AttachBatch(std::vector<JobSpec> specs)
+    {
+        AddJobs(specs.data(), specs.size());
+    }
+
+#if defined(__cpp_lib_span)
+    inline void PooledScheduler::AttachBatch(std::span<const JobSpec> specs)
+    {
+        AttachBatch(std::vector<JobSpec>(specs.begin(), specs.end()));
+    }
+#endif
+
+    inline bool PooledScheduler::Detach(IScheduledWorker& scheduleItem)
+    {
+        return DetachIf([&scheduleItem](const PooledJob& job) { return &job.GetWorker() == &scheduleItem; });
+    }
+
+    inline bool PooledScheduler::Detach(const char* name)
+    {
+        if (name == nullptr)
+        {
+            return false;
+        }
+        return DetachIf([name](const PooledJob& job) {
+            const char* workerName = job.GetWorker().GetWorkerName();
+            return workerName != nullptr && std::strcmp(workerName, name) == 0;
+        });
+    }
+
+    inline bool PooledScheduler::Wake(const IScheduledWorker& scheduleItem)
+    {
+        return WakeJob(FindJob([&scheduleItem](const PooledJob& job) { return &job.GetWorker() == &scheduleItem; }));
+    }
+
+    inline bool PooledScheduler::Wake(const char* name)
+    {
+        return WakeJob(FindJobByName(name));
+    }
+
+    inline PooledScheduler::Trigger PooledScheduler::AttachTriggered(IScheduledWorker& scheduleItem,
+                                                                     const TaskPriority threadPriority,
+                                                                     Millisecond maxLatency)
+    {
+        JobSpec spec(scheduleItem, maxLatency, threadPriority);
+        spec.triggered = true;
+        return Trigger(*this, AddJobs(&spec, 1));
+    }
+
+    inline PooledScheduler::Trigger PooledScheduler::GetTrigger(const char* name)
+    {
+        Item job = FindJobByName(name);
+        if (!job)
+        {
+            return Trigger();
+        }
+        return Trigger(*this, std::move(job));
+    }
+
+    inline bool PooledScheduler::GetStatistics(const IScheduledWorker& scheduleItem,
+                                               RoutineTimeSnapshot& snapshot) const
+    {
+        const Item job = FindJob([&scheduleItem](const PooledJob& job) { return &job.GetWorker() == &scheduleItem; });
+        if (!job)
+        {
+            return false;
+        }
+        snapshot = job->GetStatistics();
+        return true;
+    }
+
+    inline bool PooledScheduler::GetStatistics(const char* name, RoutineTimeSnapshot& snapshot) const
+    {
+        const Item job = FindJobByName(name);
+        if (!job)
+        {
+            return false;
+        }
+        snapshot = job->GetStatistics();
+        return true;
+    }
+
+    inline bool PooledScheduler::GetLatencyHistograms(const char* name, RoutineLatencyHistogram& duration,
+                                                      RoutineLatencyHistogram& interval) const
+    {
+        const Item job = FindJobByName(name);
+        if (!job || job->GetMonitor().GetDurationHistogram() == nullptr)
+        {
+            return false;
+        }
+        job->GetMonitor().GetDurationHistogram()->CopyTo(duration);
+        job->GetMonitor().GetIntervalHistogram()->CopyTo(interval);
+        return true;
+    }
+
+    template <typename Visitor>
+    inline std::size_t PooledScheduler::CollectStats(Visitor visitor) const
+    {
+        const std::shared_ptr<const ScheduleContainer> current = workers.Load();
+        JobStats stats;
+        for (const auto& job : *current)
+        {
+            const PublishedRoutineTimeMonitor& monitor = job->GetMonitor();
+            stats.name = job->GetWorker().GetWorkerName();
+            stats.interval = static_cast<Microsecond>(job->GetInterval().count());
+            stats.errorCount = job->GetErrorCount();
+            stats.timing = monitor.Snapshot();
+            stats.durationHistogram = monitor.GetDurationHistogram();
+            stats.intervalHistogram = monitor.GetIntervalHistogram();
+            stats.cpuAccounting = monitor.IsCpuAccounting();
+            visitor(static_cast<const JobStats&>(stats));
+        }
+        return current->size();
+    }
+
+    template <typename Visitor>
+    inline std::size_t PooledScheduler::CollectRunning(Visitor visitor) const
+    {
+        const std::shared_ptr<const ScheduleContainer> current = workers.Load();
+        const Clock::time_point now = Clock::now();
+        std::size_t running = 0;
+        RunningJob execution;
+        for (const auto& job : *current)
+        {
+            if (!job->GetRunning(execution.since, execution.threadId) || !job->Pin())
+            {
+                continue;
+            }
+            execution.worker = &job->GetWorker();
+            execution.name = execution.worker->GetWorkerName();
+            execution.runningFor =
+                now > execution.since
+                    ? static_cast<Microsecond>(
+                          std::chrono::duration_cast<std::chrono::microseconds>(now - execution.since).count())
+                    : 0;
+            execution.expectedDuration = job->GetDurationLimit();
+            const PooledJob* const outer = PinnedJob();
+            PinnedJob() = job.get();
+            try
+            {
+                visitor(static_cast<const RunningJob&>(execution));
+            }
+            catch (...)
+            {
+                PinnedJob() = outer;
+                job->Unpin();
+                throw;
+            }
+            PinnedJob() = outer;
+            job->Unpin();
+            ++running;
+        }
+        return running;
+    }
+
+    inline bool PooledScheduler::ReportDurationTimeout(const RunningJob& execution) const
+    {
+        const Item job = FindJob([&execution](const PooledJob& job) {
+            Clock::time_point since;
+            uint64_t threadId = 0;
+            return &job.GetWorker() == execution.worker && job.GetRunning(since, threadId) && since == execution.since;
+        });
+        if (!job || !job->ClaimTimeout(execution.since))
+        {
+            return false;
+        }
+        execution.worker->NotifyDurationTimeout(true);
+        return true;
+    }
+
+    template <typename Predicate>
+    inline PooledScheduler::Item PooledScheduler::FindJob(Predicate predicate) const
+    {
+        const std::shared_ptr<const ScheduleContainer> current = workers.Load();
+        for (const auto& job : *current)
+        {
+            if (predicate(*job))
+            {
+                return job;
+            }
+        }
+        return Item();
+    }
+
+    inline PooledScheduler::Item PooledScheduler::FindJobByName(const char* name) const
+    {
+        if (name == nullptr)
+        {
+            return Item();
+        }
+        return FindJob([name](const PooledJob& job) {
+            const char* workerName = job.GetWorker().GetWorkerName();
+            return workerName != nullptr && std::strcmp(workerName, name) == 0;
+        });
+    }
+
+    inline PooledScheduler::PooledJob*& PooledScheduler::CurrentJob()
+    {
+        static thread_local PooledJob* current = nullptr;
+        return current;
+    }
+
+    inline const PooledScheduler::PooledJob*& PooledScheduler::PinnedJob()
+    {
+        static thread_local const PooledJob* pinned = nullptr;
+        return pinned;
+    }
+
+    inline PooledScheduler::Item PooledScheduler::AddJobs(JobSpec* specs, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return Item();
+        }
+        const IntrusivePtr<JobBlock> block(JobBlock::Create(*resource, count));
+        ScheduleContainer added;
+        added.reserve(count);
+        const Clock::time_point now = Clock::now();
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            JobSpec& spec = specs[index];
+            IScheduledWorker& hostWorker =
+                spec.worker != nullptr ? *spec.worker
+                                       : block->AddAgent(spec.name.c_str(), Store<ActionStorage>(spec.action),
+                                                         Store<CallbackStorage>(spec.callback));
+            ThreadPool& jobPool = PlacePool(spec.placement);
+            const Microsecond interval =
+                spec.preciseInterval != 0 ? spec.preciseInterval : spec.interval * MicrosecondInMillisecond;
+            Item job(&block->AddJob(*this, hostWorker, jobPool, interval, spec.timing, spec.catchUp,
+                                    spec.threadPriority, spec.duration, spec.latencyHistograms,
+                                    spec.cpuAccounting, spec.triggered));
+            job->inboxDeadline = now;
+            if (spec.triggered)
+            {
+                // Waits for the first notification or its timeout.
+                job->inboxDeadline =
+                    interval != 0 ? now + std::chrono::microseconds(interval) : (Clock::time_point::max)();
+            }
+            added.push_back(std::move(job));
+        }
+        Publish(added);
+        return added.back();
+    }
+
+    inline ThreadPool& PooledScheduler::PlacePool(const ThreadPlacement& placement)
+    {
+        if (placement.kind == ThreadPlacement::Kind::Any)
+        {
+            return pool;
+        }
+        if (placement.kind == ThreadPlacement::Kind::SameAs)
+        {
+            const Item followed = FindJobByName(placement.jobName.c_str());
+            if (!followed)
+            {
+                LogFilter::Format<LogLevel::Warning>("job %s to share threads with is not attached",
+                                                     placement.jobName.c_str());
+                return pool;
+            }
+            return followed->GetPool();
+        }
+        std::vector<uint32_t> processors = placement.ResolveProcessors();
+        if (processors.empty())
+        {
+            LogFilter::Format<LogLevel::Warning>("placement on NUMA node %u has no processors", placement.numaNode);
+            return pool;
+        }
+
+        std::lock_guard<std::mutex> lock(lanesMutex);
+        for (const auto& lane : lanes)
+        {
+            if (lane->GetAffinity() == processors)
+            {
+                return *lane;
+            }
+        }
+        const std::string name = "PooledScheduler-Lane" + std::to_string(lanes.size());
+        const uint32_t threadCount = static_cast<uint32_t>(processors.size());
+        lanes.emplace_back(new ThreadPool(threadCount, workerTaskPriority, name.c_str(), std::move(processors)));
+        if (lanesActive)
+        {
+            lanes.back()->Start();
+        }
+        return *lanes.back();
+    }
+
+    template <typename Storage, typename Callable>
+    inline Storage PooledScheduler::Store(Callable& callable)
+    {
+        if (!callable)
+        {
+            return Storage();
+        }
+        return Storage(std::move(callable));
+    }
+
+    inline void PooledScheduler::AddActionJob(const char* name, ActionStorage action, CallbackStorage callback,
+                                              Millisecond interval, TaskPriority priority)
+    {
+        const Millisecond duration = callback ? interval : 0;
+        const IntrusivePtr<JobBlock> block(JobBlock::Create(*resource, 1));
+        ActionWorker& agent = block->AddAgent(name, std::move(action), std::move(callback));
+        ScheduleContainer added(1, Item(&block->AddJob(*this, agent, pool, interval * MicrosecondInMillisecond,
+                                                       TimingMode::Relative, CatchUpPolicy::FireOnce, priority,
+                                                       duration, false, false, false)));
+        added.front()->inboxDeadline = Clock::now();
+        Publish(added);
+    }
+
+    inline std::shared_ptr<PooledScheduler::ScheduleContainer> PooledScheduler::MakeContainer() const
+    {
+        // The polymorphic allocator passes its resource on to the vector it constructs.
+        return std::allocate_shared<ScheduleContainer>(std::pmr::polymorphic_allocator<ScheduleContainer>(resource));
+    }
+
+    inline void PooledScheduler::Publish(ScheduleContainer& added)
+    {
+        for (std::size_t index = 0; index < added.size(); ++index)
+        {
+            added[index]->inboxNext = index == 0 ? nullptr : added[index - 1].get();
+            added[index]->inboxSelf = added[index];
+        }
+        {
+            std::lock_guard<std::mutex> lock(workersMutex);
+            const std::shared_ptr<const ScheduleContainer> current = workers.Load();
+            std::shared_ptr<ScheduleContainer> updated = MakeContainer();
+            updated->reserve(current->size() + added.size());
+            updated->assign(current->begin(), current->end());
+            updated->insert(updated->end(), added.begin(), added.end());
+            workers.Store(std::move(updated));
+        }
+        Post(added.back().get(), added.front().get());
+    }
+
+    template <typename Predicate>
+    inline bool PooledScheduler::DetachIf(Predicate predicate)
+    {
+        ScheduleContainer removed;
+        {
+            std::lock_guard<std::mutex> lock(workersMutex);
+            const std::shared_ptr<const ScheduleContainer> current = workers.Load();
+            std::shared_ptr<ScheduleContainer> updated = MakeContainer();
+            updated->reserve(current->size());
+            for (const auto& job : *current)
+            {
+                if (predicate(*job))
+                {
+                    removed.push_back(job);
+                }
+                else
+                {
+                    updated->push_back(job);
+                }
+            }
+            if (removed.empty())
+            {
+                return false;
+            }
+            workers.Store(std::move(updated));
+        }
+        for (const auto& job : removed)
+        {
+            job->Detach();
+            PostWake(job);
+        }
+        return true;
+    }
+
+    inline void PooledScheduler::Post(Item job, const Clock::time_point& deadline)
+    {
+        PooledJob* posted = job.get();
+        posted->inboxDeadline = deadline;
+        posted->inboxSelf = std::move(job);
+        Post(posted, posted);
+    }
+
+    inline void PooledScheduler::Post(PooledJob* first, PooledJob* last)
+    {
+        last->inboxNext = inbox.load(std::memory_order_relaxed);
+        while (!inbox.compare_exchange_weak(last->inboxNext, first))
+        {
+        }
+        if (sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            cond.notify_one();
+        }
+    }
+
+    inline void PooledScheduler::QueuePosition::Placed(Item& job, std::size_t index)
+    {
+        job->queueIndex = index;
+    }
+
+    inline void PooledScheduler::QueuePosition::Removed(Item& job)
+    {
+        job->queueIndex = PooledJob::NOT_QUEUED;
+    }
+
+    inline void PooledScheduler::DrainInbox()
+    {
+        PooledJob* posted = inbox.exchange(nullptr, std::memory_order_acquire);
+        while (posted != nullptr)
+        {
+            const Clock::time_point deadline = posted->inboxDeadline;
+            Item job = std::move(posted->inboxSelf);
+            posted = posted->inboxNext;
+            if (job->queueIndex != PooledJob::NOT_QUEUED && deadlines.DeadlineAt(job->queueIndex) <= deadline)
+            {
+                // Re-posted by a missed execution after a wake queued the job again: the deadline
+                // of the wake stands rather than being moved back to the catch-up slot.
+                continue;
+            }
+            Schedule(std::move(job), deadline);
+        }
+    }
+
+    inline void PooledScheduler::Schedule(Item job, const Clock::time_point& deadline)
+    {
+        if (job->queueIndex != PooledJob::NOT_QUEUED)
+        {
+            if (deadline == (Clock::time_point::max)())
+            {
+                deadlines.Erase(job->queueIndex);
+            }
+            else
+            {
+                deadlines.Update(job->queueIndex, deadline);
+            }
+        }
+        else if (deadline != (Clock::time_point::max)())
+        {
+            deadlines.Push(deadline, std::move(job));
+        }
+    }
+
+    inline bool PooledScheduler::WakeJob(const Item& job)
+    {
+        if (!job || job->IsDetached())
+        {
+            return false;
+        }
+        PostWake(job);
+        return true;
+    }
+
+    inline void PooledScheduler::PostWake(const Item& job)
+    {
+        if (job->wakeRequested.exchange(true))
+        {
+            return;
+        }
+        PooledJob* woken = job.get();
+        woken->wakeSelf = job;
+        woken->wakeNext = wakeInbox.load(std::memory_order_relaxed);
+        while (!wakeInbox.compare_exchange_weak(woken->wakeNext, woken))
+        {
+        }
+        if (sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            cond.notify_one();
+        }
+    }
+
+    inline void PooledScheduler::DrainWakes()
+    {
+        PooledJob* woken = wakeInbox.exchange(nullptr, std::memory_order_acquire);
+        const Clock::time_point now = Clock::now();
+        while (woken != nullptr)
+        {
+            Item job = std::move(woken->wakeSelf);
+            woken = woken->wakeNext;
+            job->wakeRequested.store(false);
+            if (job->IsDetached())
+            {
+                // Woken by DetachIf() to release the entry now rather than at its deadline.
+                Schedule(std::move(job), (Clock::time_point::max)());
+            }
+            else
+            {
+                job->woken.store(true);
+                if (job->queueIndex == PooledJob::NOT_QUEUED || now < deadlines.DeadlineAt(job->queueIndex))
+                {
+                    Schedule(std::move(job), now);
+                }
+            }
+        }
+    }
+
+    inline bool PooledScheduler::HasPosts() const
+    {
+#if CONCURRENCY_HAS_COROUTINES
+        if (timerInbox.load() != nullptr)
+        {
+            return true;
+        }
+#endif
+        return inbox.load() != nullptr || wakeInbox.load() != nullptr;
+    }
+
+    inline bool PooledScheduler::IsOwnThread()
+    {
+        const ThreadPool* const current = ThreadPool::GetCurrent();
+        if (current == nullptr)
+        {
+            return false;
+        }
+        if (current == &pool)
+        {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(lanesMutex);
+        for (const auto& lane : lanes)
+        {
+            if (current == lane.get())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool PooledScheduler::IsStopped() const
+    {
+        return terminated.load() && asyncRuns.load() == 0;
+    }
+
+#if CONCURRENCY_HAS_COROUTINES
+    inline void PooledScheduler::PostTimer(TimerAwaiter& timer)
+    {
+        timer.next = timerInbox.load(std::memory_order_relaxed);
+        while (!timerInbox.compare_exchange_weak(timer.next, &timer))
+        {
+        }
+        if (sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            cond.notify_one();
+        }
+    }
+
+    inline void PooledScheduler::DrainTimers()
+    {
+        TimerAwaiter* posted = timerInbox.exchange(nullptr, std::memory_order_acquire);
+        while (posted != nullptr)
+        {
+            TimerAwaiter* next = posted->next;
+            timers.Push(posted->deadline, posted);
+            posted = next;
+        }
+    }
+
+    inline void PooledScheduler::EndAsyncRun()
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        if (asyncRuns.fetch_sub(1) == 1 && terminated.load())
+        {
+            cond.notify_one();
+        }
+    }
+
+    inline PooledScheduler::TimerAwaiter PooledScheduler::Delay(Millisecond delay)
+    {
+        return TimerAwaiter(*this, Clock::now() + std::chrono::milliseconds(delay));
+    }
+
+    inline PooledScheduler::TimerAwaiter PooledScheduler::DelayUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        return TimerAwaiter(*this, deadline);
+    }
+
+    inline PooledScheduler::PoolAwaiter PooledScheduler::Schedule()
+    {
+        return PoolAwaiter(*this);
+    }
+
+    inline PooledScheduler::TimerAwaiter::TimerAwaiter(PooledScheduler& owner, Clock::time_point deadline)
+        : owner(&owner), deadline(deadline), job(nullptr), next(nullptr)
+    {
+    }
+
+    inline bool PooledScheduler::TimerAwaiter::await_ready() const noexcept
+    {
+        return deadline <= Clock::now();
+    }
+
+    inline void PooledScheduler::TimerAwaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        this->handle = handle;
+        job = CurrentJob();
+        owner->PostTimer(*this);
+    }
+
+    inline void PooledScheduler::TimerAwaiter::await_resume() const noexcept
+    {
+    }
+
+    inline bool PooledScheduler::TimerAwaiter::Run()
+    {
+        PooledJob*& current = CurrentJob();
+        current = job;
+        handle.resume();
+        current = nullptr;
+        return false;
+    }
+
+    inline PooledScheduler::PoolAwaiter::PoolAwaiter(PooledScheduler& owner) : owner(&owner), job(nullptr)
+    {
+    }
+
+    inline bool PooledScheduler::PoolAwaiter::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    inline void PooledScheduler::PoolAwaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        this->handle = handle;
+        job = CurrentJob();
+        (job != nullptr ? job->GetPool() : owner->pool).Submit(*this);
+    }
+
+    inline void PooledScheduler::PoolAwaiter::await_resume() const noexcept
+    {
+    }
+
+    inline bool PooledScheduler::PoolAwaiter::Run()
+    {
+        PooledJob*& current = CurrentJob();
+        current = job;
+        handle.resume();
+        current = nullptr;
+        return false;
+    }
+#endif
+
+    inline void PooledScheduler::Release(const Item& job)
+    {
+        if (dispatchPolicy == DispatchPolicy::Immediate || &job->GetPool() != &pool || job->IsAsync())
+        {
+            job->Submit(job);
+            return;
+        }
+        ready.push_back(ReadyEntry{job->GetReleaseDeadline(), job->GetInterval(), job->GetPriority(), job});
+        std::push_heap(ready.begin(), ready.end(), ReadyOrder{dispatchPolicy == DispatchPolicy::RateMonotonic});
+    }
+
+    inline void PooledScheduler::FeedPool()
+    {
+        const uint32_t capacity = pool.GetThreadCount();
+        const ReadyOrder order{dispatchPolicy == DispatchPolicy::RateMonotonic};
+        while (!ready.empty() && (terminated.load() || rationedRuns.load() < capacity))
+        {
+            std::pop_heap(ready.begin(), ready.end(), order);
+            const Item job = std::move(ready.back().job);
+            ready.pop_back();
+            if (terminated.load() || job->IsDetached())
+            {
+                job->Complete(job);
+            }
+            else if (IsShed(*job))
+            {
+                job->Skip(job);
+            }
+            else
+            {
+                rationedRuns.fetch_add(1);
+                job->SetRationed();
+                job->Submit(job);
+            }
+        }
+        readyWaiting.store(!ready.empty());
+    }
+
+    inline bool PooledScheduler::CanFeed() const
+    {
+        return !ready.empty() && rationedRuns.load() < pool.GetThreadCount();
+    }
+
+    inline bool PooledScheduler::IsShed(const PooledJob& job) const
+    {
+        if (overloadPolicy == OverloadPolicy::RunLate || Clock::now() < job.GetReleaseDeadline())
+        {
+            return false;
+        }
+        return overloadPolicy == OverloadPolicy::SkipLate || job.GetPriority() < shedPriority;
+    }
+
+    inline void PooledScheduler::EndRationedRun()
+    {
+        rationedRuns.fetch_sub(1);
+        if (readyWaiting.load())
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            cond.notify_one();
+        }
+    }
+
+    inline void PooledScheduler::Submit(Action action)
+    {
+        pool.Submit(std::move(action));
+    }
+
+    inline void PooledScheduler::Submit(ITask& task)
+    {
+        pool.Submit(task);
+    }
+
+    inline void PooledScheduler::SetDispatchTiming(const DispatchTiming& timing)
+    {
+        std::lock_guard<std::mutex> activation(activationMutex);
+        dispatchTiming = timing;
+    }
+
+    inline void PooledScheduler::SetIdleStrategy(const IdleStrategy& strategy)
+    {
+        pool.SetIdleStrategy(strategy);
+    }
+
+    inline void PooledScheduler::SetIdleStrategy(const ThreadPlacement& placement, const IdleStrategy& strategy)
+    {
+        PlacePool(placement).SetIdleStrategy(strategy);
+    }
+
+    inline void PooledScheduler::SetDispatchPolicy(DispatchPolicy policy, OverloadPolicy overload,
+                                                   TaskPriority shedPriority)
+    {
+        std::lock_guard<std::mutex> activation(activationMutex);
+        dispatchPolicy = policy;
+        overloadPolicy = overload;
+        this->shedPriority = shedPriority;
+    }
+
+    inline void PooledScheduler::Activate()
+    {
+        std::lock_guard<std::mutex> activation(activationMutex);
+        if (active)
+        {
+            return;
+        }
+        terminated.store(false);
+        pool.Start();
+        {
+            std::lock_guard<std::mutex> lock(lanesMutex);
+            for (const auto& lane : lanes)
+            {
+                lane->Start();
+            }
+            lanesActive = true;
+        }
+        thread = std::thread([this]() {
+            ThisThread::SetName("PooledScheduler");
+            ThisThread::SetPriority(workerTaskPriority);
+            while (Run())
+            {
+            }
+        });
+        active = true;
+    }
+
+    inline void PooledScheduler::Deactivate()
+    {
+        // Checked before taking activationMutex, which a concurrent Deactivate() holds while it
+        // waits for this very thread.
+        if (IsOwnThread())
+        {
+            LogFilter::Format<LogLevel::Error>(
+                "PooledScheduler::Deactivate called from one of its pool threads is ignored, it would join itself");
+            return;
+        }
+        std::lock_guard<std::mutex> activation(activationMutex);
+        if (!active)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            terminated.store(true);
+        }
+        cond.notify_all();
+        thread.join();
+        FeedPool();
+        pool.Stop();
+        // A job completing on a lane may still place a job on a new lane, so the lanes are
+        // stopped outside lanesMutex. Lanes are never removed, which keeps the pointers valid.
+        std::vector<ThreadPool*> stopping;
+        {
+            std::lock_guard<std::mutex> lock(lanesMutex);
+            lanesActive = false;
+            for (const auto& lane : lanes)
+            {
+                stopping.push_back(lane.get());
+            }
+        }
+        for (ThreadPool* lane : stopping)
+        {
+            lane->Stop();
+        }
+        active = false;
+    }
+
+    inline bool PooledScheduler::Run()
+    {
+        if (IsStopped())
+        {
+            return false;
+        }
+        DrainInbox();
+        DrainWakes();
+#if CONCURRENCY_HAS_COROUTINES
+        DrainTimers();
+#endif
+        const Clock::time_point now = Clock::now();
+        while (!terminated.load() && !deadlines.Empty() && deadlines.TopDeadline() <= now)
+        {
+            const Item& job = deadlines.Top();
+            const PooledJob::Dispatch dispatch =
+                job->IsDetached() ? PooledJob::Dispatch::Dropped : job->TryDispatch(deadlines.TopDeadline(), now);
+            if (dispatch == PooledJob::Dispatch::Dropped)
+            {
+                deadlines.Pop();
+                continue;
+            }
+            const Clock::time_point next = job->GetNextDeadline();
+            if (dispatch == PooledJob::Dispatch::Claimed)
+            {
+                Release(job);
+            }
+            if (next == (Clock::time_point::max)())
+            {
+                // Waits for the next wake.
+                deadlines.Pop();
+                continue;
+            }
+            deadlines.ReplaceTop(next);
+        }
+        FeedPool();
+        Clock::time_point wakeup = (Clock::time_point::max)();
+        if (!terminated.load() && !deadlines.Empty())
+        {
+            wakeup = deadlines.TopDeadline();
+        }
+#if CONCURRENCY_HAS_COROUTINES
+        while (!timers.Empty() && timers.TopDeadline() <= now)
+        {
+            TimerAwaiter& timer = *timers.Top();
+            (timer.job != nullptr ? timer.job->GetPool() : pool).Submit(timer);
+            timers.Pop();
+        }
+        if (!timers.Empty())
+        {
+            wakeup = (std::min)(wakeup, timers.TopDeadline());
+        }
+#endif
+
+        const std::chrono::microseconds preciseWindow(dispatchTiming.preciseWindow);
+        if (preciseWindow.count() > 0 && wakeup != (Clock::time_point::max)() && wakeup - Clock::now() <= preciseWindow)
+        {
+            timer.WaitUntil(wakeup, std::chrono::microseconds(dispatchTiming.spinPhase));
+            return !IsStopped();
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        sleeping.store(true);
+        if (!HasPosts() && !CanFeed() && !IsStopped())
+        {
+            if (wakeup == (Clock::time_point::max)())
+            {
+                cond.wait(lock);
+            }
+            else
+            {
+                cond.wait_until(lock, wakeup - preciseWindow);
+            }
+        }
+        sleeping.store(false);
+        return !IsStopped();
+    }
+
+    inline uint32_t PooledScheduler::GetPoolSize() const
+    {
+        return pool.GetThreadCount();
+    }
+} // namespace Concurrency
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "LatencyHistogram.hpp"
+#include "NativeThread.hpp"
+#include "RoutineTimeMonitor.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A consistent copy of the statistics of a RoutineTimeMonitor.
+     */
+    struct RoutineTimeSnapshot
+    {
+        Microsecond maxDuration;
+        Microsecond minDuration;
+        Microsecond currentDuration;
+        Microsecond maxInterval;
+        Microsecond minInterval;
+        Microsecond currentInterval;
+        uint64_t elapsedFaultCount;
+        uint64_t intervalFaultCount;
+
+        /**
+         * @brief The number of completed Start/Stop cycles.
+         */
+        uint64_t sampleCount;
+
+        /**
+         * @brief The processor time of the last accounted execution in microseconds. The CPU
+         * fields stay 0 unless CPU accounting is enabled.
+         *
+         * A duration well above its CPU time means the execution was blocked or preempted, a CPU
+         * time close to the duration that it was computing.
+         */
+        Microsecond currentCpuTime;
+        Microsecond maxCpuTime;
+        Microsecond totalCpuTime;
+
+        /**
+         * @brief The processor cycles of the last accounted execution, on Windows only.
+         */
+        uint64_t currentCpuCycles;
+
+        /**
+         * @brief The context switches during all accounted executions, on Linux only.
+         */
+        uint64_t voluntarySwitches;
+        uint64_t involuntarySwitches;
+    };
+
+    /**
+     * @brief The histogram type recording the durations and intervals of a routine in microseconds.
+     */
+    using RoutineLatencyHistogram = LatencyHistogram<>;
+
+    /**
+     * @brief A RoutineTimeMonitor whose statistics can be read safely from any thread.
+     *
+     * The monitored thread updates the statistics exactly as RoutineTimeMonitor does, then publishes
+     * a copy of them through a sequence lock. Publishing is a handful of relaxed stores and never
+     * waits, while Snapshot() retries until it has read a copy that was not torn by a concurrent
+     * Stop(). The getters inherited from RoutineTimeMonitor must still only be called from the
+     * monitored thread.
+     *
+     * Optionally, every Stop() also records the duration and interval into a pair of latency
+     * histograms, which give the tail percentiles that the minimum and maximum cannot. CPU
+     * accounting optionally adds the processor time and context switches of every routine.
+     *
+     * Start(), Stop(), IncrementIntervalFaultCount() and the reset methods must be called from one
+     * thread at a time.
+     */
+    class PublishedRoutineTimeMonitor : public RoutineTimeMonitor
+    {
+    public:
+        /**
+         * @brief Construct a new Published Routine Time Monitor object.
+         *
+         * @param expectedDuration The expected duration of the routine in microseconds.
+         * @param expectedInterval The expected interval between routine executions in microseconds.
+         */
+        PublishedRoutineTimeMonitor(const Microsecond expectedDuration, const Microsecond expectedInterval)
+            : RoutineTimeMonitor(expectedDuration, expectedInterval),
+              sequence(0),
+              samples(0),
+              cpuAccounting(false),
+              cpuStarted(false),
+              cpuStart(),
+              cpuTotals()
+        {
+            Publish();
+        }
+
+        /**
+         * @brief Start monitoring the routine time, and its processor time if enabled.
+         */
+        void Start()
+        {
+            if (cpuAccounting)
+            {
+                cpuThread = std::this_thread::get_id();
+                cpuStarted = ThisThread::GetCpuUsage(cpuStart);
+            }
+            RoutineTimeMonitor::Start();
+        }
+
+        /**
+         * @brief Stop monitoring the routine time and publish the updated statistics.
+         *
+         * The processor time is only accounted if the routine stopped on the thread it started
+         * on, which a resumed coroutine may not.
+         */
+        void Stop()
+        {
+            if (cpuStarted && cpuThread == std::this_thread::get_id())
+            {
+                AccountCpu();
+            }
+            cpuStarted = false;
+            RoutineTimeMonitor::Stop();
+            ++samples;
+            if (histograms)
+            {
+                histograms->duration.Record(GetCurrentDuration());
+                if (samples > 1)
+                {
+                    histograms->interval.Record(GetCurrentInterval());
+                }
+            }
+            Publish();
+        }
+
+        /**
+         * @brief Starts recording the durations and intervals into latency histograms.
+         *
+         * Must be called before the monitor is shared with other threads. Does nothing if the
+         * histograms are already enabled.
+         */
+        void EnableHistograms()
+        {
+            if (!histograms)
+            {
+                histograms.reset(new Histograms());
+            }
+        }
+
+        /**
+         * @brief Starts accounting the processor time and context switches of every routine.
+         *
+         * Costs a few system calls per routine. Must be called before the monitor is shared
+         * with other threads.
+         */
+        void EnableCpuAccounting()
+        {
+            cpuAccounting = true;
+        }
+
+        /**
+         * @brief Checks whether the processor time of the routines is accounted.
+         */
+        bool IsCpuAccounting() const
+        {
+            return cpuAccounting;
+        }
+
+        /**
+         * @brief Get the histogram of the routine durations. Safe to query from any thread.
+         *
+         * @return const RoutineLatencyHistogram* The duration histogram, nullptr if the histograms are not enabled.
+         */
+        const RoutineLatencyHistogram* GetDurationHistogram() const
+        {
+            return histograms ? &histograms->duration : nullptr;
+        }
+
+        /**
+         * @brief Get the histogram of the intervals between routine executions. Safe to query from any thread.
+         *
+         * @return const RoutineLatencyHistogram* The interval histogram, nullptr if the histograms are not enabled.
+         */
+        const RoutineLatencyHistogram* GetIntervalHistogram() const
+        {
+            return histograms ? &histograms->interval : nullptr;
+        }
+
+        /**
+         * @brief Increment the interval fault count and publish the updated statistics.
+         */
+        void IncrementIntervalFaultCount()
+        {
+            RoutineTimeMonitor::IncrementIntervalFaultCount();
+            Publish();
+        }
+
+        void ResetElapsedTiming(const bool& reset) override
+        {
+            RoutineTimeMonitor::ResetElapsedTiming(reset);
+            Publish();
+        }
+
+        void ResetIntervalTiming(const bool& reset) override
+        {
+            RoutineTimeMonitor::ResetIntervalTiming(reset);
+            Publish();
+        }
+
+        /**
+         * @brief Get a consistent copy of the last published statistics. Safe to call from any thread.
+         *
+         * @return RoutineTimeSnapshot The published statistics.
+         */
+        RoutineTimeSnapshot Snapshot() const
+        {
+            RoutineTimeSnapshot snapshot;
+            for (;;)
+            {
+                const uint64_t before = sequence.load(std::memory_order_acquire);
+                if ((before & 1) == 0)
+                {
+                    snapshot.maxDuration = published.maxDuration.load(std::memory_order_relaxed);
+                    snapshot.minDuration = published.minDuration.load(std::memory_order_relaxed);
+                    snapshot.currentDuration = published.currentDuration.load(std::memory_order_relaxed);
+                    snapshot.maxInterval = published.maxInterval.load(std::memory_order_relaxed);
+                    snapshot.minInterval = published.minInterval.load(std::memory_order_relaxed);
+                    snapshot.currentInterval = published.currentInterval.load(std::memory_order_relaxed);
+                    snapshot.elapsedFaultCount = published.elapsedFaultCount.load(std::memory_order_relaxed);
+                    snapshot.intervalFaultCount = published.intervalFaultCount.load(std::memory_order_relaxed);
+                    snapshot.sampleCount = published.sampleCount.load(std::memory_order_relaxed);
+                    snapshot.currentCpuTime = published.currentCpuTime.load(std::memory_order_relaxed);
+                    snapshot.maxCpuTime = published.maxCpuTime.load(std::memory_order_relaxed);
+                    snapshot.totalCpuTime = published.totalCpuTime.load(std::memory_order_relaxed);
+                    snapshot.currentCpuCycles = published.currentCpuCycles.load(std::memory_order_relaxed);
+                    snapshot.voluntarySwitches = published.voluntarySwitches.load(std::memory_order_relaxed);
+                    snapshot.involuntarySwitches = published.involuntarySwitches.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == before)
+                    {
+                        return snapshot;
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Histograms
+        {
+            RoutineLatencyHistogram duration;
+            RoutineLatencyHistogram interval;
+        };
+
+        struct PublishedFields
+        {
+            std::atomic<Microsecond> maxDuration;
+            std::atomic<Microsecond> minDuration;
+            std::atomic<Microsecond> currentDuration;
+            std::atomic<Microsecond> maxInterval;
+            std::atomic<Microsecond> minInterval;
+            std::atomic<Microsecond> currentInterval;
+            std::atomic<uint64_t> elapsedFaultCount;
+            std::atomic<uint64_t> intervalFaultCount;
+            std::atomic<uint64_t> sampleCount;
+            std::atomic<Microsecond> currentCpuTime;
+            std::atomic<Microsecond> maxCpuTime;
+            std::atomic<Microsecond> totalCpuTime;
+            std::atomic<uint64_t> currentCpuCycles;
+            std::atomic<uint64_t> voluntarySwitches;
+            std::atomic<uint64_t> involuntarySwitches;
+        };
+
+        /**
+         * @brief The CPU statistics as kept by the monitored thread.
+         */
+        struct CpuTotals
+        {
+            Microsecond current;
+            Microsecond max;
+            Microsecond total;
+            uint64_t cycles;
+            uint64_t voluntarySwitches;
+            uint64_t involuntarySwitches;
+        };
+
+        void AccountCpu()
+        {
+            ThreadCpuUsage stop;
+            if (!ThisThread::GetCpuUsage(stop))
+            {
+                return;
+            }
+            cpuTotals.current = (stop.cpuTime - cpuStart.cpuTime) / 1000;
+            if (cpuTotals.current > cpuTotals.max)
+            {
+                cpuTotals.max = cpuTotals.current;
+            }
+            cpuTotals.total += cpuTotals.current;
+            cpuTotals.cycles = stop.cycles - cpuStart.cycles;
+            cpuTotals.voluntarySwitches += stop.voluntarySwitches - cpuStart.voluntarySwitches;
+            cpuTotals.involuntarySwitches += stop.involuntarySwitches - cpuStart.involuntarySwitches;
+        }
+
+        void Publish()
+        {
+            const uint64_t current = sequence.load(std::memory_order_relaxed);
+            sequence.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            published.maxDuration.store(GetMaxDuration(), std::memory_order_relaxed);
+            published.minDuration.store(GetMinDuration(), std::memory_order_relaxed);
+            published.currentDuration.store(GetCurrentDuration(), std::memory_order_relaxed);
+            published.maxInterval.store(GetMaxInterval(), std::memory_order_relaxed);
+            published.minInterval.store(GetMinInterval(), std::memory_order_relaxed);
+            published.currentInterval.store(GetCurrentInterval(), std::memory_order_relaxed);
+            published.elapsedFaultCount.store(GetElapsedFaultCount(), std::memory_order_relaxed);
+            published.intervalFaultCount.store(GetIntervalFaultCount(), std::memory_order_relaxed);
+            published.sampleCount.store(samples, std::memory_order_relaxed);
+            published.currentCpuTime.store(cpuTotals.current, std::memory_order_relaxed);
+            published.maxCpuTime.store(cpuTotals.max, std::memory_order_relaxed);
+            published.totalCpuTime.store(cpuTotals.total, std::memory_order_relaxed);
+            published.currentCpuCycles.store(cpuTotals.cycles, std::memory_order_relaxed);
+            published.voluntarySwitches.store(cpuTotals.voluntarySwitches, std::memory_order_relaxed);
+            published.involuntarySwitches.store(cpuTotals.involuntarySwitches, std::memory_order_relaxed);
+            sequence.store(current + 2, std::memory_order_release);
+        }
+
+        std::atomic<uint64_t> sequence;
+        PublishedFields published;
+        uint64_t samples;
+        std::unique_ptr<Histograms> histograms;
+        bool cpuAccounting;
+        bool cpuStarted;
+        std::thread::id cpuThread;
+        ThreadCpuUsage cpuStart;
+        CpuTotals cpuTotals;
+    };
+} // namespace Concurrency
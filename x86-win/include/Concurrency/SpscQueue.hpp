@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Concurrency
+{
+    /**
+     * @brief A bounded lock-free ring queue for one producer thread and one consumer thread.
+     *
+     * The producer and the consumer each own one index on a cache line of its own, and each keeps
+     * a private copy of the other's index that it only refreshes when the ring looks full or
+     * empty, so a push or pop in the steady state touches no shared cache line but the slot. The
+     * batch operations publish many items with a single index store.
+     *
+     * @tparam T The item type, which must be default constructible and move assignable.
+     */
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        /**
+         * @brief Construct a new Spsc Queue object.
+         *
+         * @param capacity The maximum number of queued items, rounded up to a power of two.
+         */
+        explicit SpscQueue(std::size_t capacity)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            mask = size - 1;
+            slots.reset(new T[size]);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        /**
+         * @brief Appends an item. Producer thread only.
+         *
+         * @param item The item to be appended, left untouched if the queue is full.
+         * @return false if the queue is full.
+         */
+        bool TryPush(T&& item)
+        {
+            const uint64_t tail = producer.index.load(std::memory_order_relaxed);
+            if (tail - producer.cached > mask)
+            {
+                producer.cached = consumer.index.load(std::memory_order_acquire);
+                if (tail - producer.cached > mask)
+                {
+                    return false;
+                }
+            }
+            slots[tail & mask] = std::move(item);
+            producer.index.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Appends a copy of an item. Producer thread only.
+         */
+        bool TryPush(const T& item)
+        {
+            T copy(item);
+            return TryPush(std::move(copy));
+        }
+
+        /**
+         * @brief Appends as many items of an array as fit. Producer thread only.
+         *
+         * @param items The items to be appended; the appended ones are moved from.
+         * @param count The number of items in the array.
+         * @return std::size_t The number of items appended, from the start of the array.
+         */
+        std::size_t PushBatch(T* items, std::size_t count)
+        {
+            const uint64_t tail = producer.index.load(std::memory_order_relaxed);
+            std::size_t free = static_cast<std::size_t>(mask + 1 - (tail - producer.cached));
+            if (free < count)
+            {
+                producer.cached = consumer.index.load(std::memory_order_acquire);
+                free = static_cast<std::size_t>(mask + 1 - (tail - producer.cached));
+            }
+            const std::size_t pushed = count < free ? count : free;
+            for (std::size_t index = 0; index < pushed; ++index)
+            {
+                slots[(tail + index) & mask] = std::move(items[index]);
+            }
+            producer.index.store(tail + pushed, std::memory_order_release);
+            return pushed;
+        }
+
+        /**
+         * @brief Removes the oldest item. Consumer thread only.
+         *
+         * @param item Receives the item on success.
+         * @return false if the queue is empty.
+         */
+        bool TryPop(T& item)
+        {
+            const uint64_t head = consumer.index.load(std::memory_order_relaxed);
+            if (head == consumer.cached)
+            {
+                consumer.cached = producer.index.load(std::memory_order_acquire);
+                if (head == consumer.cached)
+                {
+                    return false;
+                }
+            }
+            item = std::move(slots[head & mask]);
+            consumer.index.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Removes up to a number of the oldest items. Consumer thread only.
+         *
+         * @param items Receives the items in queue order.
+         * @param count The maximum number of items to be removed.
+         * @return std::size_t The number of items removed.
+         */
+        std::size_t PopBatch(T* items, std::size_t count)
+        {
+            const uint64_t head = consumer.index.load(std::memory_order_relaxed);
+            std::size_t available = static_cast<std::size_t>(consumer.cached - head);
+            if (available < count)
+            {
+                consumer.cached = producer.index.load(std::memory_order_acquire);
+                available = static_cast<std::size_t>(consumer.cached - head);
+            }
+            const std::size_t popped = count < available ? count : available;
+            for (std::size_t index = 0; index < popped; ++index)
+            {
+                items[index] = std::move(slots[(head + index) & mask]);
+            }
+            consumer.index.store(head + popped, std::memory_order_release);
+            return popped;
+        }
+
+        /**
+         * @brief Gets the approximate number of queued items. Safe from any thread.
+         */
+        std::size_t Size() const
+        {
+            const uint64_t head = consumer.index.load(std::memory_order_acquire);
+            const uint64_t tail = producer.index.load(std::memory_order_acquire);
+            return tail > head ? static_cast<std::size_t>(tail - head) : 0;
+        }
+
+        /**
+         * @brief Gets the maximum number of queued items.
+         */
+        std::size_t GetCapacity() const
+        {
+            return static_cast<std::size_t>(mask + 1);
+        }
+
+    private:
+        struct alignas(64) Side
+        {
+            std::atomic<uint64_t> index{0};
+            uint64_t cached = 0;
+        };
+
+        Side producer;
+        Side consumer;
+        uint64_t mask;
+        std::unique_ptr<T[]> slots;
+    };
+} // namespace Concurrency
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "NativeThread.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief Where the threads executing a job may run.
+     *
+     * PooledScheduler runs the jobs placed on processors on a dedicated lane of pool threads pinned
+     * to those processors, shared by every job with the same processor set; unplaced jobs run on
+     * the main pool. Pinning keeps a latency-critical loop on its cache and off processors reserved
+     * for other work, and pinning a memory-heavy job to a NUMA node keeps the memory it touches
+     * first on that node.
+     */
+    struct ThreadPlacement
+    {
+        enum class Kind : int
+        {
+            /**
+             * @brief No placement, the job runs on the main pool.
+             */
+            Any,
+            /**
+             * @brief The job runs on threads pinned to an explicit set of logical processors.
+             */
+            Processors,
+            /**
+             * @brief The job runs on threads pinned to the processors of a NUMA node.
+             */
+            NumaNode,
+            /**
+             * @brief The job runs on the same threads as an already attached job.
+             */
+            SameAs
+        };
+
+        /**
+         * @brief Construct a placement without any restriction.
+         */
+        ThreadPlacement() : kind(Kind::Any), numaNode(0)
+        {
+        }
+
+        /**
+         * @brief Places a job onto a set of logical processors.
+         *
+         * @param processors The indices of the processors, numbered as for ThisThread::SetAffinity().
+         */
+        static ThreadPlacement OnProcessors(std::vector<uint32_t> processors)
+        {
+            ThreadPlacement placement;
+            placement.kind = Kind::Processors;
+            placement.processors = std::move(processors);
+            return placement;
+        }
+
+        /**
+         * @brief Places a job onto the processors of a NUMA node.
+         *
+         * @param node The index of the NUMA node.
+         */
+        static ThreadPlacement OnNumaNode(uint32_t node)
+        {
+            ThreadPlacement placement;
+            placement.kind = Kind::NumaNode;
+            placement.numaNode = node;
+            return placement;
+        }
+
+        /**
+         * @brief Places a job onto the threads of another job.
+         *
+         * @param name The name of the worker or task whose job is followed. It must be attached
+         * before the job being placed.
+         */
+        static ThreadPlacement SameAs(const char* name)
+        {
+            ThreadPlacement placement;
+            placement.kind = Kind::SameAs;
+            placement.jobName = name == nullptr ? "" : name;
+            return placement;
+        }
+
+        /**
+         * @brief Resolves the placement to the sorted set of processors to pin to.
+         *
+         * @return std::vector<uint32_t> The processors, empty for Any and SameAs placements and for
+         * NUMA nodes that do not exist.
+         */
+        std::vector<uint32_t> ResolveProcessors() const
+        {
+            std::vector<uint32_t> resolved;
+            if (kind == Kind::Processors)
+            {
+                resolved = processors;
+            }
+            else if (kind == Kind::NumaNode)
+            {
+                resolved = ThisThread::GetNumaNodeProcessors(numaNode);
+            }
+            std::sort(resolved.begin(), resolved.end());
+            resolved.erase(std::unique(resolved.begin(), resolved.end()), resolved.end());
+            return resolved;
+        }
+
+        Kind kind;
+        std::vector<uint32_t> processors;
+        uint32_t numaNode;
+        std::string jobName;
+    };
+} // namespace Concurrency
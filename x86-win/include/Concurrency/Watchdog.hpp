@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "JobStats.hpp"
+#include "LogFilter.hpp"
+#include "NativeThread.hpp"
+#include "PooledScheduler.hpp"
+
+namespace Concurrency
+{
+    /**
+     * @brief A background thread detecting executions of a PooledScheduler that overrun their
+     * expected duration while they are still running.
+     *
+     * A duration timeout is otherwise only observed once RunOnce() returns, so a hung job stays
+     * invisible until it finishes, if it ever does. The watchdog scans the executions in progress
+     * through PooledScheduler::CollectRunning() at a fixed period, and reports every execution
+     * running longer than the expected duration of its job once: it logs a warning naming the
+     * stuck thread, calls the stall callback, and optionally notifies the worker through
+     * NotifyDurationTimeout(true), which for a task attached with a timeout callback calls that
+     * callback. A worker notified by the watchdog is not notified of the same timeout again when
+     * the execution returns.
+     *
+     * A stall is therefore reported at most one scan period after the execution overran. The
+     * callbacks run on the watchdog thread, concurrently with the stuck execution, and must be
+     * thread-safe. Detaching the stuck job from another thread waits for them to return. The stall
+     * callback may detach the stuck job itself, as a failover: the call returns once the execution
+     * has completed, and the watchdog does not notify the worker afterwards. The watchdog must be
+     * destroyed before the scheduler.
+     */
+    class Watchdog
+    {
+    public:
+        typedef std::function<void(const RunningJob&)> StallCallback;
+
+        /**
+         * @brief Construct a new Watchdog object and start its thread.
+         *
+         * @param scheduler The scheduler whose executions are watched.
+         * @param scanInterval The period between two scans in milliseconds.
+         * @param callback The callback to be called with every stalled execution, may be empty.
+         * @param notifyWorkers Whether stalled workers are notified with NotifyDurationTimeout(true).
+         * @param defaultLimit The limit in milliseconds for jobs attached without an expected
+         * duration, 0 leaves them unwatched.
+         */
+        Watchdog(const PooledScheduler& scheduler, Millisecond scanInterval, StallCallback callback = StallCallback(),
+                 bool notifyWorkers = true, Millisecond defaultLimit = 0);
+
+        /**
+         * @brief Stops and joins the watchdog thread.
+         */
+        ~Watchdog();
+
+        Watchdog(const Watchdog&) = delete;
+        Watchdog& operator=(const Watchdog&) = delete;
+
+        /**
+         * @brief Gets the number of stalled executions reported so far.
+         */
+        uint64_t GetStallCount() const;
+
+    private:
+        struct Reported
+        {
+            const IScheduledWorker* worker;
+            std::chrono::steady_clock::time_point since;
+            bool seen;
+        };
+
+        void Run();
+        void Scan();
+
+        const PooledScheduler& scheduler;
+        const std::chrono::milliseconds scanInterval;
+        const StallCallback callback;
+        const bool notifyWorkers;
+        const Millisecond defaultLimit;
+        std::vector<Reported> reported;
+        std::atomic<uint64_t> stalls;
+
+        std::atomic<bool> terminated;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::thread thread;
+    };
+
+    inline Watchdog::Watchdog(const PooledScheduler& scheduler, Millisecond scanInterval, StallCallback callback,
+                              bool notifyWorkers, Millisecond defaultLimit)
+        : scheduler(scheduler),
+          scanInterval(scanInterval == 0 ? 1 : scanInterval),
+          callback(std::move(callback)),
+          notifyWorkers(notifyWorkers),
+          defaultLimit(defaultLimit),
+          stalls(0),
+          terminated(false)
+    {
+        thread = std::thread([this]() { Run(); });
+    }
+
+    inline Watchdog::~Watchdog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            terminated.store(true);
+        }
+        cond.notify_all();
+        thread.join();
+    }
+
+    inline uint64_t Watchdog::GetStallCount() const
+    {
+        return stalls.load(std::memory_order_relaxed);
+    }
+
+    inline void Watchdog::Run()
+    {
+        ThisThread::SetName("Watchdog");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!terminated.load())
+        {
+            cond.wait_for(lock, scanInterval);
+            if (terminated.load())
+            {
+                break;
+            }
+            lock.unlock();
+            Scan();
+            lock.lock();
+        }
+    }
+
+    inline void Watchdog::Scan()
+    {
+        for (Reported& entry : reported)
+        {
+            entry.seen = false;
+        }
+        scheduler.CollectRunning([this](const RunningJob& execution) {
+            const Millisecond limit = execution.expectedDuration != 0 ? execution.expectedDuration : defaultLimit;
+            if (limit == 0 || execution.runningFor <= limit * MicrosecondInMillisecond)
+            {
+                return;
+            }
+            for (Reported& entry : reported)
+            {
+                if (entry.worker == execution.worker && entry.since == execution.since)
+                {
+                    entry.seen = true;
+                    return;
+                }
+            }
+            reported.push_back(Reported{execution.worker, execution.since, true});
+            stalls.fetch_add(1, std::memory_order_relaxed);
+            LogFilter::Format<LogLevel::Warning>(
+                "worker %s stalled on thread %llu, running for %llu us, expected %llu ms", execution.name,
+                static_cast<unsigned long long>(execution.threadId),
+                static_cast<unsigned long long>(execution.runningFor), static_cast<unsigned long long>(limit));
+            try
+            {
+                if (callback)
+                {
+                    callback(execution);
+                }
+                if (notifyWorkers)
+                {
+                    scheduler.ReportDurationTimeout(execution);
+                }
+            }
+            catch (...)
+            {
+                LogFilter::Format<LogLevel::Error>("watchdog callback for worker %s failed", execution.name);
+            }
+        });
+        // Forget the executions that have completed since they were reported.
+        reported.erase(std::remove_if(reported.begin(), reported.end(), [](const Reported& entry) { return !entry.seen; }),
+                       reported.end());
+    }
+} // namespace Concurrency
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Concurrency
+{
+    /**
+     * @brief A Chase-Lev work-stealing deque.
+     *
+     * The owning thread pushes and takes items at the bottom end without locking, while any other
+     * thread may steal items from the top end. Only the owner may call Push and Take; Steal and
+     * Empty are safe from every thread. The storage grows on demand, and retired buffers are kept
+     * until the deque is destroyed so a concurrent thief never reads released memory.
+     *
+     * @tparam T The item type, which must be trivially copyable (typically a pointer).
+     */
+    template <typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque items must be trivially copyable");
+
+    public:
+        /**
+         * @brief Construct a new Work Stealing Deque object.
+         *
+         * @param capacity The initial capacity, rounded up to a power of two.
+         */
+        explicit WorkStealingDeque(std::size_t capacity = 256) : top(0), bottom(0)
+        {
+            std::size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            buffers.emplace_back(new Buffer(size));
+            buffer.store(buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /**
+         * @brief Pushes an item at the bottom end. Owner thread only.
+         *
+         * @param item The item to be pushed.
+         */
+        void Push(T item)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_acquire);
+            Buffer* current = buffer.load(std::memory_order_relaxed);
+            if (b - t > static_cast<int64_t>(current->mask))
+            {
+                current = Grow(current, t, b);
+            }
+            current->Put(b, item);
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Takes the most recently pushed item from the bottom end. Owner thread only.
+         *
+         * @param item Receives the item on success.
+         * @return true if an item was taken, false if the deque was empty.
+         */
+        bool Take(T& item)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Buffer* current = buffer.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = current->Get(b);
+            if (t == b)
+            {
+                const bool won =
+                    top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Steals the oldest item from the top end. Safe from any thread.
+         *
+         * @param item Receives the item on success.
+         * @return true if an item was stolen, false if the deque was empty or the race was lost.
+         */
+        bool Steal(T& item)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b)
+            {
+                return false;
+            }
+            Buffer* current = buffer.load(std::memory_order_acquire);
+            item = current->Get(t);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Checks whether the deque appears empty. Safe from any thread.
+         *
+         * @return true if no item was observed.
+         */
+        bool Empty() const
+        {
+            const int64_t t = top.load(std::memory_order_acquire);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+            return t >= b;
+        }
+
+    private:
+        struct Buffer
+        {
+            explicit Buffer(std::size_t size) : mask(size - 1), slots(new std::atomic<T>[size])
+            {
+            }
+
+            T Get(int64_t index) const
+            {
+                return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+            }
+
+            void Put(int64_t index, T item)
+            {
+                slots[static_cast<std::size_t>(index) & mask].store(item, std::memory_order_relaxed);
+            }
+
+            const std::size_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        Buffer* Grow(Buffer* current, int64_t t, int64_t b)
+        {
+            buffers.emplace_back(new Buffer((current->mask + 1) << 1));
+            Buffer* grown = buffers.back().get();
+            for (int64_t index = t; index < b; ++index)
+            {
+                grown->Put(index, current->Get(index));
+            }
+            buffer.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        std::atomic<Buffer*> buffer;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+    };
+} // namespace Concurrency